@@ -0,0 +1,305 @@
+#include "DataGrid.h"
+#include "FakeBackend.h"
+#include "ResultRecording.h"
+#include "RowOperations.h"
+#include "TableData.h"
+#include "TableFetch.h"
+#include "imgui/imgui.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Mikrobenchmarki gorących ścieżek: dekodowanie nagranego wyniku do TableData (getTableData na ReplayBackend),
+// pełna ścieżka pobierania na FakeBackend, rysowanie siatki (bez okna i GL) i budowanie SQL formularzy. Wynik jako JSON - do porównywania między wydaniami.
+//   bench [--out <plik.json>] [--min-time <sekundy>]
+
+// Liczniki alokacji - globalny operator new tego programu
+static std::atomic<uint64_t> allocationCount{ 0 };
+static std::atomic<uint64_t> allocationBytes{ 0 };
+
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size > 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+// ImGui alokuje przez własne MemAlloc - liczone tak samo
+static void* countingImGuiAlloc(size_t size, void*)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size);
+}
+
+static void countingImGuiFree(void* p, void*)
+{
+    std::free(p);
+}
+
+struct Measurement
+{
+    std::string name;
+    uint64_t itemsPerOp = 0; // wiersze (dekodowanie), klatki (siatka), zapytania (SQL)
+    uint64_t iterations = 0;
+    double seconds = 0.0;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+};
+
+// Powtarza op co najmniej minSeconds (po jednym przebiegu rozgrzewającym)
+template <typename Op>
+static Measurement measure(const std::string& name, uint64_t itemsPerOp, double minSeconds, Op&& op)
+{
+    using Clock = std::chrono::steady_clock;
+    op();
+
+    Measurement m;
+    m.name = name;
+    m.itemsPerOp = itemsPerOp;
+
+    const uint64_t allocsBefore = allocationCount.load();
+    const uint64_t bytesBefore = allocationBytes.load();
+    const Clock::time_point start = Clock::now();
+    do
+    {
+        op();
+        ++m.iterations;
+        m.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (m.seconds < minSeconds);
+
+    m.allocations = allocationCount.load() - allocsBefore;
+    m.allocatedBytes = allocationBytes.load() - bytesBefore;
+    std::cerr << name << ": " << m.iterations << " iterations in " << m.seconds << " s" << std::endl;
+    return m;
+}
+
+// --- Dekodowanie ---
+
+// Nagranie wyniku getTableData z FakeBackend - odtwarzane wiersze są już gotowe w pamięci, więc pomiar
+// obejmuje getTableData i readResultSet z aplikacji, bez kosztu generowania wartości przez FakeBackend
+static bool loadOrdersReplay(size_t rows, ReplayBackend& replay)
+{
+    FakeBackend fake;
+    fake.addTable(FakeBackend::makeOrdersTable(rows));
+    std::unique_ptr<DbConnection> fakeConn = fake.connect(DbEndpoint{}, "bench");
+
+    ResultRecorder recorder;
+    recorder.start();
+    {
+        RecordingConnection recording(*fakeConn, recorder);
+        getTableData(recording, "orders");
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "dbmanager-bench-orders.rec").string();
+    std::string error;
+    const bool loaded = recorder.stopAndSave(path, error) && replay.load(path, error);
+    std::filesystem::remove(path);
+    if (!loaded)
+        std::cerr << "Cannot prepare decode benchmark: " << error << std::endl;
+    return loaded;
+}
+
+// Tabela do pomiaru siatki - ta sama ścieżka pobierania co w aplikacji, bez limitów wierszy i pamięci
+static TableData fetchOrders(size_t rows)
+{
+    FakeBackend backend;
+    backend.addTable(FakeBackend::makeOrdersTable(rows));
+    std::unique_ptr<DbConnection> conn = backend.connect(DbEndpoint{}, "bench");
+    TableQuery query;
+    query.limits = QueryLimits{ 0.0, 0, 0, true };
+    return getTableData(*conn, "orders", query);
+}
+
+// --- Siatka ---
+
+// Siatka w kontekście ImGui bez backendu: pełna klatka NewFrame..Render, bez rysowania na GPU
+static Measurement benchmarkGrid(const TableData& data, double minSeconds)
+{
+    ImGui::SetAllocatorFunctions(countingImGuiAlloc, countingImGuiFree, nullptr);
+    ImGuiContext* context = ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1920.0f, 1080.0f);
+    io.DeltaTime = 1.0f / 60.0f;
+    io.IniFilename = nullptr;
+    io.Fonts->Build();
+
+    DataGrid grid;
+    TableQuery query;
+    const std::vector<std::string>& headers = data.getHeaders();
+    auto frame = [&]()
+    {
+        ImGui::NewFrame();
+        ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+        ImGui::SetNextWindowSize(io.DisplaySize);
+        ImGui::Begin("Bench", nullptr, ImGuiWindowFlags_NoDecoration);
+        grid.render("orders", headers, "id", data.getRowCount(), [&data](size_t row) { return RowRef{ &data, row }; }, query);
+        ImGui::End();
+        ImGui::Render();
+    };
+
+    // Kilka klatek na ustalenie układu tabeli
+    for (int i = 0; i < 3; ++i)
+        frame();
+
+    Measurement m = measure("show_table/" + std::to_string(data.getRowCount()), 1, minSeconds, frame);
+    ImGui::DestroyContext(context);
+    return m;
+}
+
+// --- SQL formularzy ---
+
+static TableSchema makeOrdersSchema()
+{
+    TableSchema schema;
+    schema.name = "orders";
+    schema.primaryKey = { "id" };
+
+    ColumnInfo id;
+    id.name = "id";
+    id.dataType = "int";
+    id.autoIncrement = true;
+    id.primaryKey = true;
+    id.nullable = false;
+    schema.columns.push_back(id);
+
+    const char* names[] = { "customer", "amount", "status", "created_at", "updated_at", "note", "ratio" };
+    for (const char* name : names)
+    {
+        ColumnInfo column;
+        column.name = name;
+        column.dataType = "varchar";
+        schema.columns.push_back(column);
+    }
+    schema.columns[3].defaultValue = "new";
+    return schema;
+}
+
+// --- JSON ---
+
+static std::string toJson(const std::vector<Measurement>& results)
+{
+    std::string json = "{\n  \"schema\": 1,\n  \"benchmarks\": [\n";
+    char line[512];
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Measurement& m = results[i];
+        const double ops = static_cast<double>(m.iterations);
+        const double items = ops * static_cast<double>(m.itemsPerOp);
+        std::snprintf(line, sizeof(line),
+                      "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.1f, \"items_per_op\": %llu, "
+                      "\"items_per_second\": %.1f, \"allocations_per_op\": %.2f, \"allocated_bytes_per_op\": %.1f}%s\n",
+                      m.name.c_str(), static_cast<unsigned long long>(m.iterations), m.seconds * 1e9 / ops,
+                      static_cast<unsigned long long>(m.itemsPerOp), m.seconds > 0.0 ? items / m.seconds : 0.0,
+                      static_cast<double>(m.allocations) / ops, static_cast<double>(m.allocatedBytes) / ops,
+                      i + 1 < results.size() ? "," : "");
+        json += line;
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+int main(int argc, char** argv)
+{
+    std::string outPath;
+    double minSeconds = 0.5;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            outPath = argv[++i];
+        else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+            minSeconds = std::atof(argv[++i]);
+        else
+        {
+            std::cerr << "Usage: bench [--out <file.json>] [--min-time <seconds>]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<Measurement> results;
+
+    {
+        const size_t rows = 100000;
+        ReplayBackend replay;
+        if (!loadOrdersReplay(rows, replay))
+            return 1;
+        std::unique_ptr<DbConnection> conn = replay.connect(DbEndpoint{}, "bench");
+        size_t decoded = 0;
+        results.push_back(measure("decode/" + std::to_string(rows), rows, minSeconds,
+                                  [&]() { decoded = getTableData(*conn, "orders").getRowCount(); }));
+        if (decoded != rows)
+            std::cerr << "unexpected row count from replay: " << decoded << std::endl;
+    }
+
+    {
+        // getTableData jak w aplikacji (SQL, readResultSet, limity), ale wiersze z FakeBackend zamiast z sieci
+        const size_t rows = 100000;
+        FakeBackend backend;
+        backend.addTable(FakeBackend::makeOrdersTable(rows));
+        std::unique_ptr<DbConnection> conn = backend.connect(DbEndpoint{}, "bench");
+        size_t fetched = 0;
+        results.push_back(measure("fetch/fake/" + std::to_string(rows), rows, minSeconds,
+                                  [&]() { fetched = getTableData(*conn, "orders").getRowCount(); }));
+        if (fetched != rows)
+            std::cerr << "unexpected row count from fake backend: " << fetched << std::endl;
+    }
+
+    for (size_t rows : { size_t{ 10000 }, size_t{ 100000 }, size_t{ 1000000 } })
+    {
+        const TableData data = fetchOrders(rows);
+        results.push_back(benchmarkGrid(data, minSeconds));
+    }
+
+    {
+        const TableSchema schema = makeOrdersSchema();
+        std::vector<std::string> cols;
+        for (const ColumnInfo& column : schema.columns)
+            cols.push_back(column.name);
+        const std::vector<std::string> values = { "", "customer-17", "129.99", "", "now", "current_timestamp()", "default", "0.5" };
+        const std::vector<std::string> updateCols(cols.begin() + 1, cols.end());
+
+        size_t sink = 0;
+        results.push_back(measure("sql/insert_row", 1, minSeconds, [&]() { sink += buildInsertSql(schema, cols, values).sql.size(); }));
+        results.push_back(measure("sql/update_row", 1, minSeconds, [&]() { sink += buildUpdateSql(schema.name, updateCols, "id").size(); }));
+        if (sink == 0)
+            std::cerr << "unexpected empty SQL" << std::endl;
+    }
+
+    const std::string json = toJson(results);
+    if (outPath.empty())
+    {
+        std::cout << json;
+    }
+    else
+    {
+        std::ofstream out(outPath);
+        out << json;
+        if (!out)
+        {
+            std::cerr << "Cannot write " << outPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+#!/bin/sh
+# Czas otwarcia tabeli, Add Row i Update Row przy różnym RTT do bazy z docker-compose.
+#   DB_PASSWORD=... bench/rtt_bench.sh [katalog-builda] [użytkownik] [baza]
+# Dla każdego RTT uruchamia rttproxy przed bazą i rttprobe przez proxy; wynik - JSON w wierszu na pomiar.
+# Zmienne: DB_TARGET (host:port bazy, domyślnie 127.0.0.1:3307), PROXY_PORT (3308), RTTS ("0 10 50 150"),
+#          JITTER_MS (0), BANDWIDTH_KBPS (0 - bez limitu), ROWS (5000), ITERATIONS (5)
+set -eu
+
+BUILD_DIR=${1:-build}
+DB_USER=${2:-root}
+DATABASE=${3:-restauracja}
+DB_TARGET=${DB_TARGET:-127.0.0.1:3307}
+PROXY_PORT=${PROXY_PORT:-3308}
+RTTS=${RTTS:-"0 10 50 150"}
+
+for rtt in $RTTS; do
+    "$BUILD_DIR/rttproxy" --listen "$PROXY_PORT" --target "$DB_TARGET" --rtt "$rtt" \
+        --jitter "${JITTER_MS:-0}" --bandwidth "${BANDWIDTH_KBPS:-0}" &
+    proxy=$!
+    trap 'kill $proxy 2>/dev/null' EXIT
+    sleep 0.5
+
+    "$BUILD_DIR/rttprobe" 127.0.0.1 "$PROXY_PORT" "$DB_USER" "$DATABASE" \
+        --rows "${ROWS:-5000}" --iterations "${ITERATIONS:-5}" --label "rtt_${rtt}ms"
+
+    kill "$proxy"
+    wait "$proxy" 2>/dev/null || true
+    trap - EXIT
+done
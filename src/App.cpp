@@ -1,9 +1,53 @@
 #include "App.h"
 #include "TableOperations.h"
+#include "PerfStats.h"
+#include "ResultRecording.h"
+#include "Trace.h"
+#include <ctime>
 #include <cstdio>  
+#include <algorithm>
+#include <cfloat>
+#include <climits>
 
-const char* ICON_FA_TRASH = "\xef\x80\x8d";
-const char* ICON_FA_PEN   = "\xef\x81\x84";
+// Klucz puli połączeń - serwer, poświadczenia i protokół, bez wybranej bazy
+static DbEndpoint makeEndpoint(const std::string& host, const std::string& port,
+                               const std::string& user, const std::string& password, bool serverPrepared = false)
+{
+    return DbEndpoint{ host, port, user, password, serverPrepared };
+}
+
+// Po zdarzeniu rysujemy kilka klatek - ImGui potrzebuje ich na ustalenie rozmiarów, hover i otwarcie popupów
+static constexpr int SETTLE_FRAMES = 3;
+static constexpr double IDLE_WAIT_SECONDS = 0.5;    // także tempo migania kursora w aktywnym polu tekstowym
+static constexpr double BUSY_REFRESH_SECONDS = 0.1; // odświeżanie wskaźników postępu
+// Tabele poniżej tych progów (według statystyk) są pobierane w całości jednym zapytaniem, większe stronicowane
+static constexpr uint64_t FULL_LOAD_MAX_ROWS = 10000;
+static constexpr uint64_t FULL_LOAD_MAX_BYTES = uint64_t{ 8 } << 20;
+
+static bool isSmallTable(const TableInfo& info)
+{
+    return info.hasStats && info.approxRows <= FULL_LOAD_MAX_ROWS && info.dataBytes <= FULL_LOAD_MAX_BYTES;
+}
+
+// Pola limitów zapytań przeglądania (okno łączenia i nakładka wydajności); 0 wyłącza limit
+static void editQueryLimits(QueryLimits& limits)
+{
+    float seconds = static_cast<float>(limits.maxStatementSeconds);
+    int rows = static_cast<int>(std::min<size_t>(limits.maxRows, INT_MAX));
+    int megabytes = static_cast<int>(std::min<size_t>(limits.maxBytes >> 20, INT_MAX));
+
+    ImGui::SetNextItemWidth(120.0f);
+    if (ImGui::InputFloat("Statement timeout (s)", &seconds, 1.0f, 10.0f, "%.1f"))
+        limits.maxStatementSeconds = std::max(seconds, 0.0f);
+    ImGui::SetNextItemWidth(120.0f);
+    if (ImGui::InputInt("Max rows", &rows, 10000, 100000))
+        limits.maxRows = static_cast<size_t>(std::max(rows, 0));
+    ImGui::SetNextItemWidth(120.0f);
+    if (ImGui::InputInt("Max result memory (MB)", &megabytes, 16, 128))
+        limits.maxBytes = static_cast<size_t>(std::max(megabytes, 0)) << 20;
+    ImGui::TextDisabled("0 disables a limit");
+    ImGui::Checkbox("Allow unlimited results (no row and no memory limit)", &limits.allowUnbounded);
+}
 
 App::App(WindowProps props) : windowProps(props)
 {
@@ -38,6 +82,8 @@ void App::init(WindowProps props)
         throw std::runtime_error("Cannot create GLFW window");
     }
 
+    TraceRecorder::setThreadName("UI");
+
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1); // vsync
 
@@ -58,6 +104,21 @@ void App::init(WindowProps props)
     icons_config.PixelSnapH = true;
     io.Fonts->AddFontFromFileTTF("../fonts/fa-solid-900.ttf", 16.0f, &icons_config, icons_ranges);
 
+    // Własne callbacki przed backendem ImGui - backend zapamiętuje je i wywołuje po swoich
+    glfwSetWindowUserPointer(window, this);
+    glfwSetCursorPosCallback(window, [](GLFWwindow* w, double, double) { onWindowEvent(w); });
+    glfwSetMouseButtonCallback(window, [](GLFWwindow* w, int, int, int) { onWindowEvent(w); });
+    glfwSetScrollCallback(window, [](GLFWwindow* w, double, double) { onWindowEvent(w); });
+    glfwSetKeyCallback(window, [](GLFWwindow* w, int, int, int, int) { onWindowEvent(w); });
+    glfwSetCharCallback(window, [](GLFWwindow* w, unsigned int) { onWindowEvent(w); });
+    glfwSetWindowSizeCallback(window, [](GLFWwindow* w, int, int) { onWindowEvent(w); });
+    glfwSetWindowFocusCallback(window, [](GLFWwindow* w, int) { onWindowEvent(w); });
+    glfwSetWindowRefreshCallback(window, [](GLFWwindow* w) { onWindowEvent(w); });
+    glfwSetCursorEnterCallback(window, [](GLFWwindow* w, int) { onWindowEvent(w); });
+
+    // Wynik zapytania budzi pętlę czekającą w glfwWaitEventsTimeout (glfwPostEmptyEvent jest bezpieczne wątkowo)
+    db.setCompletionNotifier([]() { glfwPostEmptyEvent(); });
+
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init("#version 330");
 }
@@ -65,7 +126,7 @@ void App::init(WindowProps props)
 void App::renderGUI() 
 {
     // Jeśli brak połączenia, pokaż okno łączenia
-    if (!conn)
+    if (!connected)
     {
         drawConnectWindow();
         drawCreateDatabaseWindow();
@@ -73,8 +134,10 @@ void App::renderGUI()
     }
 
     // Jeśli połączono, pokaż główne okno
-    if (conn)
+    if (connected)
         showMain();
+
+    drawFrameStats();
 }
 
 void App::drawConnectWindow()
@@ -95,25 +158,20 @@ void App::drawConnectWindow()
         ImGui::PopItemWidth();
 
         ImGui::Spacing();
-        if (ImGui::Button("Refresh DBs", ImVec2(120, 0)))
+        if (ImGui::Button("Refresh DBs", ImVec2(120, 0)) && !adminBusy)
         {
-            std::string err;
             availableDatabases.clear();
             selectedDatabaseIndex = -1;
-            if (!fetchDatabases(availableDatabases, err))
-            {
-                connectError = err;
-            }
-            else
+            fetchDatabases([this](std::vector<std::string>& databases)
             {
-                connectError.clear();
+                availableDatabases = std::move(databases);
                 if (!availableDatabases.empty())
                 {
                     // ustawienie domyślnej bazy na pierwszą z listy
                     selectedDatabaseIndex = 0;
                     std::snprintf(dbBuf, sizeof(dbBuf), "%s", availableDatabases[0].c_str());
                 }
-            }
+            });
         }
 
         ImGui::SameLine();
@@ -141,6 +199,12 @@ void App::drawConnectWindow()
         ImGui::PushItemWidth(320.0f);
         ImGui::InputText("Database (manual)", dbBuf, sizeof(dbBuf));
         ImGui::PopItemWidth();
+        ImGui::Checkbox("Binary protocol (server-side prepared statements)", &binaryProtocolOpt);
+        if (ImGui::TreeNode("Query limits"))
+        {
+            editQueryLimits(queryLimits);
+            ImGui::TreePop();
+        }
 
         if (!connectError.empty())
         {
@@ -149,19 +213,26 @@ void App::drawConnectWindow()
         }
 
         ImGui::Spacing();
-        if (ImGui::Button("Connect", ImVec2(120, 0)))
+        if (connecting)
         {
-            std::string err;
-            if (tryConnect(err))
-            {
-                connectError.clear();
-                auto tables = getTablesFromDatabase(*conn);
-                tableSelector.setTables(tables);
-            }
-            else
-            {
-                connectError = err;
-            }
+            ImGui::TextDisabled("Connecting...");
+        }
+        else if (ImGui::Button("Connect", ImVec2(120, 0)))
+        {
+            tryConnect();
+        }
+
+        if (adminBusy)
+        {
+            ImGui::SameLine();
+            ImGui::TextDisabled("Working...");
+        }
+
+        const ConnectionPoolStats poolStats = db.pool().getStats();
+        if (poolStats.checkouts > 0)
+        {
+            ImGui::TextDisabled("Pool: %zu idle, %zu in use, hit rate %.0f%%, avg wait %.1f ms",
+                                poolStats.idle, poolStats.inUse, poolStats.getHitRate() * 100.0, poolStats.getAverageWaitMs());
         }
     }
     ImGui::End();
@@ -184,18 +255,9 @@ void App::drawCreateDatabaseWindow()
         ImGui::PopItemWidth();
 
         ImGui::Spacing();
-        if (ImGui::Button("Create Database", ImVec2(150, 0)))
+        if (ImGui::Button("Create Database", ImVec2(150, 0)) && !adminBusy)
         {
-            std::string error;
-            if (createDatabase(hostBuf, userBuf, passBuf, newDbName))
-            {
-                std::snprintf(dbBuf, sizeof(dbBuf), "%s", newDbName);
-                connectError.clear();
-            }
-            else
-            {
-                connectError = error;
-            }
+            createDatabase(hostBuf, userBuf, passBuf, newDbName);
         }
     }
     ImGui::End();
@@ -215,24 +277,19 @@ void App::drawDropDatabaseWindow()
 
         ImGui::PushItemWidth(320.0f);
 
-        if (ImGui::Button("Refresh DBs", ImVec2(120, 0)))
+        if (ImGui::Button("Refresh DBs", ImVec2(120, 0)) && !adminBusy)
         {
-            std::string err;
             availableDatabases.clear();
             selectedDatabaseIndex = -1;
-            if (!fetchDatabases(availableDatabasesForDrop, err))
+            fetchDatabases([this](std::vector<std::string>& databases)
             {
-                connectError = err;
-            }
-            else
-            {
-                connectError.clear();
+                availableDatabasesForDrop = std::move(databases);
                 if (!availableDatabasesForDrop.empty())
                 {
                     selectedDatabaseIndex = 0;
                     std::snprintf(dropDbName, sizeof(dropDbName), "%s", availableDatabasesForDrop[0].c_str());
                 }
-            }
+            });
         }
 
         ImGui::SameLine();
@@ -277,18 +334,11 @@ void App::drawDropDatabaseWindow()
             ImGui::TextUnformatted("Are you sure you want to drop the database?");
             ImGui::Separator();
 
-            if (ImGui::Button("Yes", ImVec2(120, 0)))
+            if (ImGui::Button("Yes", ImVec2(120, 0)) && !adminBusy)
             {
-                std::string error;
-                if (dropDatabase(hostBuf, userBuf, passBuf, dropDbName))
-                {
-                    connectError.clear();
-                    ImGui::CloseCurrentPopup();
-                }
-                else
-                {
-                    connectError = error;
-                }
+                // Błąd pojawi się w oknie po zakończeniu zadania
+                dropDatabase(hostBuf, userBuf, passBuf, dropDbName);
+                ImGui::CloseCurrentPopup();
             }
 
             ImGui::SameLine();
@@ -303,125 +353,143 @@ void App::drawDropDatabaseWindow()
     ImGui::End();
 }
 
-bool App::dropDatabase(const std::string& host, const std::string& user, const std::string& password, const std::string& dbName)
+void App::dropDatabase(const std::string& host, const std::string& user, const std::string& password, const std::string& dbName)
 {
-    try
-    {
-        // Połączenie bez określonej bazy danych
-        sql::Driver* driver = sql::mariadb::get_driver_instance();
-        std::string endpoint = "tcp://" + host + ":" + std::string(portBuf); 
-
-        std::unique_ptr<sql::Connection> tmpConn(driver->connect(endpoint.c_str(), user.c_str(), password.c_str()));
-
-        // Usunięcie bazy danych 
-        std::unique_ptr<sql::Statement> stmt(tmpConn->createStatement());
-        stmt->execute("DROP DATABASE IF EXISTS " + dbName);
+    adminBusy = true;
+    db.submit(
+        [host, port = std::string(portBuf), user, password, dbName](DbSession& session)
+        {
+            // Połączenie bez określonej bazy danych
+            PooledConnection tmpConn = session.pool().checkout(makeEndpoint(host, port, user, password));
+
+            // Usunięcie bazy danych 
+            std::unique_ptr<sql::Statement> stmt(tmpConn->createStatement());
+            measureStatement([&] { return stmt->execute("DROP DATABASE IF EXISTS " + dbName); });
+            session.schema().invalidate(); // DDL
+            return true;
+        },
+        [this, dbName](DbResult<bool>& result)
+        {
+            adminBusy = false;
+            if (!result.ok())
+            {
+                std::cerr << "Failed to drop database: " << result.error << std::endl;
+                connectError = result.error;
+                return;
+            }
 
-        std::cout << "Database '" << dbName << "' dropped if it existed.\n";
-        return true;
-    }
-    catch (sql::SQLException& e)
-    {
-        std::cerr << "Failed to drop database: " << e.what()
-                  << "\nError code: " << e.getErrorCode()
-                  << "\nSQLState: " << e.getSQLState() << std::endl;
-        return false;
-    }
+            std::cout << "Database '" << dbName << "' dropped if it existed.\n";
+            connectError.clear();
+        });
 }
 
-bool App::tryConnect(std::string& outError)
+void App::tryConnect()
 {
-    try
-    {
-        sql::Driver* driver = sql::mariadb::get_driver_instance();
-        std::string endpoint = "tcp://" + std::string(hostBuf) + ":" + std::string(portBuf);
-
-        std::unique_ptr<sql::Connection> newConn(driver->connect(
-            endpoint.c_str(), userBuf, passBuf
-        ));
+    DbConnProps props;
+    props.host = hostBuf;
+    props.port = portBuf;
+    props.user = userBuf;
+    props.password = passBuf;
+    props.database = dbBuf;
+    props.binaryProtocol = binaryProtocolOpt;
+
+    connecting = true;
+    db.submit(
+        [props](DbSession& session)
+        {
+            const DbEndpoint endpoint = makeEndpoint(props.host, props.port, props.user, props.password, props.binaryProtocol);
+            PooledConnection newConn = session.pool().checkout(endpoint);
 
-        // Jeśli użytkownik podał nazwę bazy w polu dbBuf -> ustawiamy
-        if (dbBuf[0] != '\0')
-            newConn->setSchema(dbBuf);
+            // Jeśli użytkownik podał nazwę bazy w polu dbBuf -> ustawiamy
+            if (!props.database.empty())
+                newConn->setSchema(props.database);
 
-        conn = std::move(newConn);
+            session.setConnection(std::move(newConn), endpoint);
 
-        // Zapisanie właściwości połączenia
-        dbConnProps.host = hostBuf;
-        dbConnProps.port = portBuf;
-        dbConnProps.user = userBuf;
-        dbConnProps.password = passBuf;
-        dbConnProps.database = dbBuf;
+            // Lista tabel w tym samym zadaniu - bez dodatkowego przejścia przez kolejkę
+            return getTablesFromDatabase(session.connection());
+        },
+        [this, props](DbResult<std::vector<TableInfo>>& result)
+        {
+            connecting = false;
+            if (!result.ok())
+            {
+                connectError = result.error;
+                connected = false;
+                return;
+            }
 
-        outError.clear();
-        return true;
-    }
-    catch (sql::SQLException& e)
-    {
-        outError = e.what();
-        conn.reset();
-        return false;
-    }
+            // Zapisanie właściwości połączenia
+            dbConnProps = props;
+            connected = true;
+            connectError.clear();
+            tableCache.clear();
+            pagedTable.close();
+            tableSelector.setTables(result.value);
+        });
 }
 
-bool App::createDatabase(const std::string& host, const std::string& user, const std::string& password, const std::string& dbName)
+void App::createDatabase(const std::string& host, const std::string& user, const std::string& password, const std::string& dbName)
 {
-    try
-    {
-        // Połączenie bez określonej bazy danych
-        sql::Driver* driver = sql::mariadb::get_driver_instance();
-        std::string endpoint = "tcp://" + host + ":" + std::string(portBuf); 
-
-        std::unique_ptr<sql::Connection> tmpConn(driver->connect(endpoint.c_str(), user.c_str(), password.c_str()));
-
-        // Utworzenie bazy danych 
-        std::unique_ptr<sql::Statement> stmt(tmpConn->createStatement());
-        stmt->execute("CREATE DATABASE IF NOT EXISTS " + dbName);
-
-        std::snprintf(dbBuf, sizeof(dbBuf), "%s", dbName.c_str());
+    adminBusy = true;
+    db.submit(
+        [host, port = std::string(portBuf), user, password, dbName](DbSession& session)
+        {
+            // Połączenie bez określonej bazy danych
+            PooledConnection tmpConn = session.pool().checkout(makeEndpoint(host, port, user, password));
+
+            // Utworzenie bazy danych 
+            std::unique_ptr<sql::Statement> stmt(tmpConn->createStatement());
+            measureStatement([&] { return stmt->execute("CREATE DATABASE IF NOT EXISTS " + dbName); });
+            session.schema().invalidate(); // DDL
+            return true;
+        },
+        [this, dbName](DbResult<bool>& result)
+        {
+            adminBusy = false;
+            if (!result.ok())
+            {
+                std::cerr << "Failed to create database: " << result.error << std::endl;
+                connectError = result.error;
+                return;
+            }
 
-        std::cout << "Database '" << dbName << "' created or already exists.\n";
-        return true;
-    }
-    catch (sql::SQLException& e)
-    {
-        std::cerr << "Failed to create database: " << e.what()
-                  << "\nError code: " << e.getErrorCode()
-                  << "\nSQLState: " << e.getSQLState() << std::endl;
-        return false;
-    }
+            std::snprintf(dbBuf, sizeof(dbBuf), "%s", dbName.c_str());
+            std::cout << "Database '" << dbName << "' created or already exists.\n";
+            connectError.clear();
+        });
 }
 
-bool App::fetchDatabases(std::vector<std::string>& outDatabases, std::string& outError)
+void App::fetchDatabases(std::function<void(std::vector<std::string>&)> onFetched)
 {
-    outDatabases.clear();
-    try
-    {
-        sql::Driver* driver = sql::mariadb::get_driver_instance();
-        std::string endpoint = "tcp://" + std::string(hostBuf) + ":" + std::string(portBuf);
-
-        // Połączenie bez ustawiania schematu 
-        std::unique_ptr<sql::Connection> tmpConn(driver->connect(endpoint.c_str(), userBuf, passBuf));
-        std::unique_ptr<sql::Statement> stmt(tmpConn->createStatement());
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SHOW DATABASES"));
+    adminBusy = true;
+    db.submit(
+        [host = std::string(hostBuf), port = std::string(portBuf), user = std::string(userBuf), password = std::string(passBuf)](DbSession& session)
+        {
+            // Połączenie bez ustawiania schematu - rozgrzane połączenie z puli, jeśli jest
+            PooledConnection tmpConn = session.pool().checkout(makeEndpoint(host, port, user, password));
+            std::unique_ptr<sql::Statement> stmt(tmpConn->createStatement());
+            std::unique_ptr<sql::ResultSet> res(measureStatement([&] { return stmt->executeQuery("SHOW DATABASES"); }));
 
-        while (res->next())
+            std::vector<std::string> databases;
+            while (res->next())
+            {
+                databases.push_back(res->getString(1).c_str());
+            }
+            return databases;
+        },
+        [this, onFetched = std::move(onFetched)](DbResult<std::vector<std::string>>& result)
         {
-            outDatabases.push_back(res->getString(1).c_str());
-        }
-        outError.clear();
-        return true;
-    }
-    catch (sql::SQLException& e)
-    {
-        outError = e.what();
-        return false;
-    }
-    catch (const std::exception& e)
-    {
-        outError = e.what();
-        return false;
-    }
+            adminBusy = false;
+            if (!result.ok())
+            {
+                connectError = result.error;
+                return;
+            }
+
+            connectError.clear();
+            onFetched(result.value);
+        });
 }
 
 void App::showMain()
@@ -443,11 +511,89 @@ void App::showMain()
     ImGui::Begin(dbConnProps.database.empty() ? "Database" : dbConnProps.database.c_str(), nullptr, hostFlags);
 
     // Pasek menu i tabela
-    std::string currentTable = tableSelector.render(*conn);
+    TableMenuActions menuActions;
+    menuActions.onRowsChanged = [this](const std::string& tableName) { onRowsChanged(tableName); };
+    menuActions.onRefreshed = [this]()
+    {
+        tableCache.invalidateAll();
+        pagedTable.close();
+    };
+    menuActions.onImportCsv = [this](const std::string& tableName) { csvImporter.open(tableName); };
+    menuActions.onExportTable = [this](const std::string& tableName) { csvExporter.open(tableName); };
+    menuActions.onBenchmarkProtocols = [this](const std::string& tableName) { protocolBenchmark.open(tableName); };
+
+    std::string currentTable = tableSelector.render(db, menuActions);
+
+    const DbEndpoint endpoint = makeEndpoint(dbConnProps.host, dbConnProps.port, dbConnProps.user, dbConnProps.password,
+                                             dbConnProps.binaryProtocol);
+    csvImporter.render(db, endpoint, dbConnProps.database, menuActions.onRowsChanged);
+    csvExporter.render(endpoint, dbConnProps.database, db.pool());
+    protocolBenchmark.render(db, endpoint, dbConnProps.database, queryLimits);
+
     if (!currentTable.empty())
     {
-        auto tableData = getTableData(*conn, currentTable);
-        showTable(tableData);
+        // Inna tabela - sortowanie i filtry zaczynają od zera
+        if (browseQueryTable != currentTable)
+        {
+            // Pełny skan poprzednio wybranej tabeli nie jest już potrzebny
+            tableCache.cancelLoadsExcept(currentTable);
+            browseQueryTable = currentTable;
+            browseQuery = TableQuery{};
+            dataGrid.reset();
+        }
+        // Limity z ustawień - ich zmiana pobiera widok od nowa, jak zmiana sortowania
+        browseQuery.limits = queryLimits;
+
+        // Strategia ze statystyk tabeli: mała - jedno pełne pobranie, duża - stronicowanie po kluczu głównym.
+        // Statystyki są szacunkowe, ale limity zapytania chronią także przed tabelą, która urosła od odświeżenia listy
+        const TableInfo* tableInfo = tableSelector.getSelectedTableInfo();
+        if (tableInfo && isSmallTable(*tableInfo))
+        {
+            if (!pagedTable.getTableName().empty())
+                pagedTable.close();
+            showFullTable(currentTable);
+        }
+        else
+        {
+            if (pagedTable.getTableName() != currentTable)
+                pagedTable.open(db, currentTable, browseQuery);
+
+            switch (pagedTable.getMode())
+            {
+            case PagedTable::Mode::Keyset:
+            {
+                // Widok stronicowany - w pamięci tylko strony wokół widocznego fragmentu
+                if (pagedTable.isLoading())
+                    ImGui::TextDisabled("Loading rows...");
+                else if (!pagedTable.getError().empty())
+                    ImGui::TextColored(ImVec4(1, 0.2f, 0.2f, 1.0f), "Error: %s", pagedTable.getError().c_str());
+
+                VisibleRows visible = showTable(pagedTable.getHeaders(), pagedTable.getPrimaryKey(), pagedTable.getRowCount(),
+                                                [this](size_t rowIndex) { return pagedTable.getRow(rowIndex); });
+                if (visible.first < visible.last)
+                    pagedTable.update(db, visible.first, visible.last);
+                break;
+            }
+            case PagedTable::Mode::Unsupported:
+                // Bez jednokolumnowego klucza nie ma stronicowania - duża tabela trafia do pamięci w całości (do limitów zapytania)
+                if (tableInfo && tableInfo->hasStats && !isSmallTable(*tableInfo))
+                    ImGui::TextDisabled("No single-column primary key - loading the whole table (~%llu rows)",
+                                        static_cast<unsigned long long>(tableInfo->approxRows));
+                showFullTable(currentTable);
+                break;
+            case PagedTable::Mode::Failed:
+                ImGui::TextColored(ImVec4(1, 0.2f, 0.2f, 1.0f), "Error: %s", pagedTable.getError().c_str());
+                break;
+            case PagedTable::Mode::Idle:
+            case PagedTable::Mode::Opening:
+                ImGui::TextDisabled("Loading %s...", currentTable.c_str());
+                break;
+            }
+
+            // Widok bez klucza głównego bierze zapytanie z tableCache.get w następnej klatce
+            if (pagedTable.getMode() == PagedTable::Mode::Keyset)
+                pagedTable.setQuery(db, browseQuery);
+        }
     }
 
     // Osługa popupu update 
@@ -457,135 +603,325 @@ void App::showMain()
         openUpdateRowRequested = false;
     }
 
-    updateRowInTable(*conn, updateTableName, updatePkColumn, updatePkValue);
+    updateRowInTable(db, updateTableName, updatePkColumn, updatePkValue,
+                     [this](const std::string& tableName) { onRowsChanged(tableName); });
 
     ImGui::End();
     ImGui::PopStyleVar(2);
 }
 
-void App::showTable(const TableData& data)
+void App::showFullTable(const std::string& tableName)
 {
-    if (data.headers.empty())
+    // Pełne dane z cache, SELECT tylko po unieważnieniu
+    const TableData* tableData = tableCache.get(db, tableName, browseQuery);
+    const std::string loadError = tableCache.getError(tableName);
+    if (!loadError.empty())
+        ImGui::TextColored(ImVec4(1, 0.2f, 0.2f, 1.0f), "Error: %s", loadError.c_str());
+    if (!tableData)
     {
-        ImGui::TextUnformatted("There is nothing to show");
+        if (loadError.empty())
+            ImGui::TextDisabled("Loading %s...", tableName.c_str());
         return;
     }
 
-    const int dataColumnCount = static_cast<int>(data.headers.size());
-    const int totalColumns = dataColumnCount + 1;
+    // Dane dochodzą partiami - siatka pokazuje już to, co przyszło
+    const TableDataCache::LoadProgress progress = tableCache.getLoadProgress(tableName);
+    if (progress.loading)
+        ImGui::TextDisabled("%zu rows loaded, %.0f rows/s...", progress.rows, progress.rowsPerSecond);
+    else if (tableData->isTruncated())
+        ImGui::TextColored(ImVec4(1, 0.75f, 0.2f, 1.0f), "Result truncated at %zu rows: %s. Narrow it down with filters or raise the limit.",
+                           tableData->getRowCount(), tableData->getTruncation().c_str());
+    showTable(tableData->getHeaders(), tableCache.getPrimaryKey(tableName), tableData->getRowCount(),
+              [tableData](size_t rowIndex) { return RowRef{ tableData, rowIndex }; });
+}
 
-    if (ImGui::BeginTable("DataTable", totalColumns,
-                          ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+void App::onRowsChanged(const std::string& tableName)
+{
+    tableCache.invalidate(tableName);
+    if (pagedTable.getTableName() == tableName)
+        pagedTable.invalidate();
+}
+
+App::VisibleRows App::showTable(const std::vector<std::string>& headers, const std::string& pkColumn, size_t rowCount,
+                                const std::function<RowRef(size_t)>& rowAt)
+{
+    DataGrid::Result result = dataGrid.render(browseQueryTable, headers, pkColumn, rowCount, rowAt, browseQuery);
+
+    const std::string tableName = tableSelector.getSelectedTable();
+    switch (result.action)
     {
-        for (const auto& header : data.headers)
-            ImGui::TableSetupColumn(header.c_str());
-        ImGui::TableSetupColumn("Actions", ImGuiTableColumnFlags_WidthFixed, 120.0f);
-        ImGui::TableHeadersRow();
+    case DataGrid::RowAction::Edit:
+        updateTableName = tableName;
+        updatePkColumn  = pkColumn;
+        updatePkValue   = result.pkValue;
+        openUpdateRowRequested = true;
+        break;
+    case DataGrid::RowAction::Delete:
+        deleteRowFromTable(db, tableName, pkColumn, result.pkValue,
+                           [this](const std::string& changedTable) { onRowsChanged(changedTable); });
+        break;
+    case DataGrid::RowAction::None:
+        break;
+    }
+
+    return result.visible;
+}
 
-        std::string tableName = tableSelector.getSelectedTable();
-        std::string pkColumn  = getPKFromTable(*conn, tableName);
+void App::run() 
+{
+    fpsWindowStart = glfwGetTime();
 
-        int pkIndex = -1;
-        if (!pkColumn.empty())
+    while (running && !glfwWindowShouldClose(window)) 
+    {
+        bool wake = false;
+        if (!idleRendering)
         {
-            for (int i = 0; i < dataColumnCount; ++i)
-            {
-                if (data.headers[i] == pkColumn)
-                {
-                    pkIndex = i;
-                    break;
-                }
-            }
+            glfwPollEvents();
+            wake = true;
+        }
+        else if (framesToRender > 0)
+        {
+            glfwPollEvents();
+        }
+        else
+        {
+            // Nic do narysowania - śpimy do zdarzenia okna, wyniku zapytania albo upływu czasu
+            // Odroczony filtr też wymaga klatki, gdy minie czas - bez niego zapytanie czekałoby na ruch myszy
+            const bool busy = hasBackgroundWork() || dataGrid.isFilterPending();
+            const bool periodic = busy || ImGui::GetIO().WantTextInput;
+            glfwWaitEventsTimeout(busy ? BUSY_REFRESH_SECONDS : IDLE_WAIT_SECONDS);
+            if (periodic)
+                framesToRender = 1;
         }
 
-        for (int rowIndex = 0; rowIndex < static_cast<int>(data.rows.size()); ++rowIndex)
+        // Wyniki zapytań z wątku bazy - callbacki aktualizują stan UI przed rysowaniem
         {
-            const auto& row = data.rows[rowIndex];
-            ImGui::TableNextRow();
-            ImGui::PushID(rowIndex);
+            TRACE_SCOPE("pollCompleted");
+            if (db.pollCompleted() > 0)
+                wake = true;
+        }
 
-            for (int c = 0; c < dataColumnCount; ++c)
-            {
-                ImGui::TableSetColumnIndex(c);
-                const char* cell = (c < static_cast<int>(row.columns.size())) ? row.columns[c].c_str() : "";
-                ImGui::TextUnformatted(cell);
-            }
+        if (inputPending)
+        {
+            inputPending = false;
+            wake = true;
+        }
 
-            ImGui::TableSetColumnIndex(dataColumnCount);
+        if (wake)
+            framesToRender = std::max(framesToRender, SETTLE_FRAMES);
 
-            float columnWidth = ImGui::GetColumnWidth(dataColumnCount);
-            float buttonWidth = 25.0f;
-            float offset = (columnWidth - 2 * buttonWidth) / 3.0f;
+        if (framesToRender == 0)
+            continue; // bez wejścia i bez nowych wyników - poprzednia klatka jest aktualna
+        --framesToRender;
 
-            ImGui::SetCursorPosX(ImGui::GetCursorPosX() + offset);
+        renderFrame();
+    }
+}
 
-            if (ImGui::SmallButton(ICON_FA_PEN))
+void App::renderFrame()
+{
+    TRACE_SCOPE("frame");
+
+    {
+        TRACE_SCOPE("NewFrame");
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::NewFrame();
+    }
+
+    int display_w, display_h;
+    glfwGetFramebufferSize(window, &display_w, &display_h);
+
+    // Czas CPU faz klatki - do nakładki Performance
+    using Clock = PerfStats::Clock;
+    auto elapsedMs = [](Clock::time_point from, Clock::time_point to) { return std::chrono::duration<double, std::milli>(to - from).count(); };
+    PerfStats::FrameTimes frameTimes;
+
+    const Clock::time_point guiStart = Clock::now();
+    renderGUI();
+
+    const Clock::time_point renderStart = Clock::now();
+    ImGui::Render();
+
+    glViewport(0, 0, display_w, display_h);
+    glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    const Clock::time_point drawStart = Clock::now();
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    const Clock::time_point drawEnd = Clock::now();
+
+    frameTimes.renderGui = elapsedMs(guiStart, renderStart);
+    frameTimes.imguiRender = elapsedMs(renderStart, drawStart);
+    frameTimes.renderDrawData = elapsedMs(drawStart, drawEnd);
+    PerfStats::instance().recordFrame(frameTimes);
+
+    // Fazy już zmierzone - do śladu trafiają te same punkty czasu
+    TraceRecorder& trace = TraceRecorder::instance();
+    if (trace.isRecording())
+    {
+        trace.addComplete("renderGUI", "app", guiStart, renderStart, {});
+        trace.addComplete("ImGui::Render", "app", renderStart, drawStart, {});
+        trace.addComplete("RenderDrawData", "app", drawStart, drawEnd, {});
+    }
+
+    {
+        TRACE_SCOPE("SwapBuffers");
+        glfwSwapBuffers(window);
+    }
+
+    ++framesInSecond;
+    const double now = glfwGetTime();
+    if (now - fpsWindowStart >= 1.0)
+    {
+        renderedFps = static_cast<double>(framesInSecond) / (now - fpsWindowStart);
+        framesInSecond = 0;
+        fpsWindowStart = now;
+    }
+}
+
+void App::onWindowEvent(GLFWwindow* window)
+{
+    if (auto* app = static_cast<App*>(glfwGetWindowUserPointer(window)))
+        app->inputPending = true;
+}
+
+bool App::hasBackgroundWork() const
+{
+    return db.isBusy() || csvImporter.isRunning() || csvExporter.isRunning();
+}
+
+void App::drawFrameStats()
+{
+    // Mała nakładka w prawym dolnym rogu
+    const ImGuiViewport* vp = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(ImVec2(vp->WorkPos.x + vp->WorkSize.x - 10.0f, vp->WorkPos.y + vp->WorkSize.y - 10.0f),
+                            ImGuiCond_Always, ImVec2(1.0f, 1.0f));
+    ImGui::SetNextWindowBgAlpha(0.6f);
+
+    const ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                                   ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+                                   ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+    if (ImGui::Begin("##FrameStats", nullptr, flags))
+    {
+        ImGui::Text("Rendered: %.1f FPS", renderedFps);
+        ImGui::SameLine();
+        ImGui::Checkbox("Idle rendering", &idleRendering);
+        ImGui::SameLine();
+        ImGui::Checkbox("Performance", &showPerfOverlay);
+
+        // Nagrywanie śladu Chrome Trace - plik otwierany w chrome://tracing lub ui.perfetto.dev
+        TraceRecorder& trace = TraceRecorder::instance();
+        if (!trace.isRecording())
+        {
+            if (ImGui::SmallButton("Record trace"))
             {
-                if (pkIndex >= 0 && pkIndex < static_cast<int>(row.columns.size()))
-                {
-                    updateTableName = tableName;
-                    updatePkColumn  = pkColumn;
-                    updatePkValue   = row.columns[pkIndex];
-                    openUpdateRowRequested = true;
-                }
-                else
-                {
-                    std::cerr << "Cannot update row: primary key column not found in headers for table "
-                              << tableName << " (pk=" << pkColumn << ")\n";
-                }
+                traceMessage.clear();
+                trace.start();
             }
-
+        }
+        else
+        {
+            ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "REC %zu events", trace.getEventCount());
             ImGui::SameLine();
-            ImGui::SetCursorPosX(ImGui::GetCursorPosX() + offset);
-
-            if (ImGui::SmallButton(ICON_FA_TRASH))
+            if (ImGui::SmallButton("Stop & save"))
             {
-                if (pkIndex >= 0 && pkIndex < static_cast<int>(row.columns.size()))
-                {
-                    const std::string& pkValue = row.columns[pkIndex];
-                    deleteRowFromTable(*conn, tableName, pkColumn, pkValue);
-                }
-                else
-                {
-                    std::cerr << "Cannot delete row: primary key column not found in headers for table "
-                              << tableName << " (pk=" << pkColumn << ")\n";
-                }
+                char fileName[64];
+                std::snprintf(fileName, sizeof(fileName), "dbmanager-trace-%lld.json",
+                              static_cast<long long>(std::time(nullptr)));
+                std::string error;
+                traceMessage = trace.stopAndSave(fileName, error) ? std::string("Trace saved to ") + fileName : error;
             }
+        }
+
+        if (!traceMessage.empty())
+            ImGui::TextDisabled("%s", traceMessage.c_str());
 
-            ImGui::PopID();
+        // Nagranie wyników zapytań - do odtworzenia przez ReplayBackend (dbtool --replay)
+        ResultRecorder& results = ResultRecorder::instance();
+        if (!results.isRecording())
+        {
+            if (ImGui::SmallButton("Record results"))
+            {
+                resultRecordingMessage.clear();
+                results.start();
+            }
+        }
+        else
+        {
+            ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "REC %zu queries", results.getQueryCount());
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Stop & save##results"))
+            {
+                char fileName[64];
+                std::snprintf(fileName, sizeof(fileName), "dbmanager-results-%lld.dbres",
+                              static_cast<long long>(std::time(nullptr)));
+                std::string error;
+                const bool saved = results.stopAndSave(fileName, error);
+                resultRecordingMessage = saved ? std::string("Results saved to ") + fileName : error;
+                if (saved && !error.empty())
+                    resultRecordingMessage += " (" + error + ")";
+            }
         }
 
-        ImGui::EndTable();
+        if (!resultRecordingMessage.empty())
+            ImGui::TextDisabled("%s", resultRecordingMessage.c_str());
     }
+    ImGui::End();
+
+    if (showPerfOverlay)
+        drawPerfOverlay();
 }
 
-void App::run() 
+void App::drawPerfOverlay()
 {
-    while (running && !glfwWindowShouldClose(window)) 
-    {
-        glfwPollEvents();
+    const PerfStats& perf = PerfStats::instance();
 
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
-
-        int display_w, display_h;
-        glfwGetFramebufferSize(window, &display_w, &display_h);
-
-        renderGUI();
+    ImGui::SetNextWindowSize(ImVec2(360, 0), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.85f);
+    if (ImGui::Begin("Performance", &showPerfOverlay, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing))
+    {
+        const PerfStats::FrameTimes& last = perf.getLastFrame();
+        const PerfStats::FrameTimes& avg = perf.getAverageFrame();
+        ImGui::TextUnformatted("CPU frame time (last / avg, ms)");
+        ImGui::Text("  renderGUI        %6.2f / %6.2f", last.renderGui, avg.renderGui);
+        ImGui::Text("  ImGui::Render    %6.2f / %6.2f", last.imguiRender, avg.imguiRender);
+        ImGui::Text("  RenderDrawData   %6.2f / %6.2f", last.renderDrawData, avg.renderDrawData);
 
-        ImGui::Render();
-        glViewport(0, 0, display_w, display_h);
-        glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        ImGui::Separator();
+        const PerfStats::LatencyPercentiles latency = perf.getLatencyPercentiles();
+        ImGui::Text("SQL statements: %llu total, %llu since previous frame",
+                    static_cast<unsigned long long>(perf.getStatementCount()),
+                    static_cast<unsigned long long>(perf.getStatementsLastFrame()));
+        ImGui::Text("Latency (last %zu): p50 %.2f ms  p95 %.2f ms  p99 %.2f ms",
+                    latency.samples, latency.p50, latency.p95, latency.p99);
 
-        glfwSwapBuffers(window);
+        ImGui::Separator();
+        ImGui::Text("Fetched: %llu rows, %.2f MB",
+                    static_cast<unsigned long long>(perf.getRowsFetched()),
+                    static_cast<double>(perf.getBytesFetched()) / (1024.0 * 1024.0));
+        int fetchSize = static_cast<int>(tableCache.getFetchSize());
+        ImGui::SetNextItemWidth(120.0f);
+        if (ImGui::InputInt("Streaming fetch size (rows)", &fetchSize, 100, 1000))
+            tableCache.setFetchSize(static_cast<size_t>(std::max(fetchSize, 1)));
+        if (ImGui::TreeNode("Query limits"))
+        {
+            editQueryLimits(queryLimits);
+            ImGui::TreePop();
+        }
+        ImGui::Text("TableData memory: %.2f MB (paged view %.2f MB in %zu pages, full-table cache %.2f MB)",
+                    static_cast<double>(pagedTable.getMemoryBytes() + tableCache.getMemoryBytes()) / (1024.0 * 1024.0),
+                    static_cast<double>(pagedTable.getMemoryBytes()) / (1024.0 * 1024.0),
+                    pagedTable.getResidentPageCount(),
+                    static_cast<double>(tableCache.getMemoryBytes()) / (1024.0 * 1024.0));
     }
+    ImGui::End();
 }
 
 void App::cleanup() 
 {
+    // Wątek bazy żyje dłużej niż GLFW - po glfwTerminate nie może już budzić pętli
+    db.setCompletionNotifier(nullptr);
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
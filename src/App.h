@@ -1,4 +1,6 @@
 #pragma once
+#include <array>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -10,6 +12,13 @@
 #include <GLFW/glfw3.h>
 #include <mariadb/conncpp.hpp>
 #include "TableSelectionBar.h"
+#include "DataGrid.h"
+#include "DbExecutor.h"
+#include "TableDataCache.h"
+#include "PagedTable.h"
+#include "CsvImport.h"
+#include "CsvExport.h"
+#include "ProtocolBenchmark.h"
 
 struct WindowProps 
 {
@@ -25,6 +34,7 @@ struct DbConnProps
     std::string user;
     std::string password;
     std::string database;
+    bool binaryProtocol = false; // zapytania przeglądania jako server-side prepared (protokół binarny)
 };
 
 class App 
@@ -40,32 +50,71 @@ private:
     void init(WindowProps props);  
     void cleanup();
     void renderGUI();
+    void renderFrame();
+
+    // Callback zdarzeń okna (wejście, zmiana rozmiaru, fokus) - oznacza, że UI trzeba przerysować
+    static void onWindowEvent(GLFWwindow* window);
+    // Zapytania, import lub eksport w toku - UI odświeża postęp co BUSY_REFRESH_SECONDS
+    bool hasBackgroundWork() const;
+    void drawFrameStats();
+    void drawPerfOverlay();
 
     // Rysuje i obsługuje okno łączenia (nie modal, zawsze widoczne dopóki brak połączenia)
     void drawConnectWindow();
     void drawCreateDatabaseWindow();
     void drawDropDatabaseWindow();
 
+    // Operacje wykonywane asynchronicznie w wątku bazy; wynik trafia do stanu okna w callbacku
     // Próba połączenia na podstawie buforów z okna
-    bool tryConnect(std::string& outError);
-    bool createDatabase(const std::string& host, const std::string& user, const std::string& password, const std::string& dbName);
-    bool dropDatabase(const std::string& host, const std::string& user, const std::string& password, const std::string& dbName);
+    void tryConnect();
+    void createDatabase(const std::string& host, const std::string& user, const std::string& password, const std::string& dbName);
+    void dropDatabase(const std::string& host, const std::string& user, const std::string& password, const std::string& dbName);
+
+    void fetchDatabases(std::function<void(std::vector<std::string>&)> onFetched);
 
-    bool fetchDatabases(std::vector<std::string>& outDbs, std::string& outError);
+    using VisibleRows = DataGrid::VisibleRows;
 
     // Widok danych po połączeniu
     void showMain();
-    void showTable(const TableData& data);
+    VisibleRows showTable(const std::vector<std::string>& headers, const std::string& pkColumn, size_t rowCount,
+                          const std::function<RowRef(size_t)>& rowAt);
+
+    // Pełne dane tabeli z tableCache - mała tabela albo brak klucza do stronicowania
+    void showFullTable(const std::string& tableName);
+
+    // Po zmianie wierszy tabeli unieważnia cache i strony widoku
+    void onRowsChanged(const std::string& tableName);
 
     GLFWwindow* window = nullptr;
     WindowProps windowProps;
     bool running = true;
 
-    // MariaDB
-    std::unique_ptr<sql::Connection> conn;
+    // Tryb bezczynny: pętla śpi w glfwWaitEventsTimeout i rysuje tylko po wejściu lub wyniku zapytania
+    bool idleRendering = true;
+    bool inputPending = true;  // ustawiane przez callbacki GLFW
+    int framesToRender = 0;    // kilka klatek po zdarzeniu, żeby ImGui ustabilizował układ
+    int framesInSecond = 0;
+    double fpsWindowStart = 0.0;
+    double renderedFps = 0.0;  // faktycznie narysowane klatki na sekundę
+    bool showPerfOverlay = false;
+    std::string traceMessage;  // ścieżka zapisanego śladu albo błąd zapisu
+    std::string resultRecordingMessage; // ścieżka zapisanego nagrania wyników albo błąd zapisu
+
+    // MariaDB - połączeniem zarządza wątek DbExecutor
+    bool connected = false;
+    bool connecting = false;
+    bool adminBusy = false; // trwa pobieranie listy baz / tworzenie / usuwanie
     DbConnProps dbConnProps; // wypełni się po udanym połączeniu
 
     TableSelectorBar tableSelector;
+    TableDataCache tableCache; // pełne dane małych tabel i tabel bez klucza głównego, odświeżane tylko po unieważnieniu
+    PagedTable pagedTable;     // widok stronicowany po kluczu głównym
+
+    // Sortowanie i filtry widoku - wykonywane po stronie serwera (ORDER BY / WHERE)
+    TableQuery browseQuery;
+    std::string browseQueryTable; // tabela, której dotyczą browseQuery i filtry siatki
+    DataGrid dataGrid;
+    QueryLimits queryLimits;      // limity każdego zapytania przeglądania (czas, wiersze, pamięć)
 
     // Stan okna łączenia (zwykłe ImGui::Begin)
     char hostBuf[128]{};
@@ -73,6 +122,7 @@ private:
     char userBuf[128]{};
     char passBuf[128]{};
     char dbBuf[128]{};
+    bool binaryProtocolOpt = false;
     std::string connectError;
 
     // Lista dostępnych baz danych 
@@ -85,8 +135,13 @@ private:
     std::string updateTableName;
     std::string updatePkColumn;
     std::string updatePkValue;
-};
 
-// Icons
-extern const char* ICON_FA_TRASH;
-extern const char* ICON_FA_PEN;
+    ProtocolBenchmark protocolBenchmark;
+
+    // Wątek bazy - deklarowany jako ostatni, żeby zatrzymał się przed niszczeniem stanu używanego w callbackach
+    DbExecutor db;
+
+    // Zadania w tle z połączeniami z puli db - deklarowane po db, żeby zakończyły się przed jej zniszczeniem
+    CsvImporter csvImporter;
+    CsvExporter csvExporter;
+};
@@ -0,0 +1,242 @@
+#include "ConnectionPool.h"
+#include <functional>
+
+std::string DbEndpoint::getKey() const
+{
+    // Hasło tylko jako skrót - klucz może trafić do logów/statystyk
+    return user + "@" + host + ":" + port + "#" + std::to_string(std::hash<std::string>{}(password)) + (serverPrepared ? "+ps" : "");
+}
+
+std::unique_ptr<sql::Connection> openConnection(const DbEndpoint& endpoint)
+{
+    sql::Driver* driver = sql::mariadb::get_driver_instance();
+    if (endpoint.serverPrepared)
+    {
+        sql::Properties properties({ { "user", endpoint.user }, { "password", endpoint.password }, { "useServerPrepStmts", "true" } });
+        return std::unique_ptr<sql::Connection>(driver->connect(endpoint.getUrl().c_str(), properties));
+    }
+    return std::unique_ptr<sql::Connection>(driver->connect(endpoint.getUrl().c_str(), endpoint.user.c_str(), endpoint.password.c_str()));
+}
+
+PooledConnection::PooledConnection(ConnectionPool* owner, std::string endpointKey, std::unique_ptr<sql::Connection> connection)
+    : pool(owner), key(std::move(endpointKey)), conn(std::move(connection))
+{
+}
+
+PooledConnection::~PooledConnection()
+{
+    giveBack();
+}
+
+PooledConnection::PooledConnection(PooledConnection&& other) noexcept
+    : pool(other.pool), key(std::move(other.key)), conn(std::move(other.conn)), reusable(other.reusable)
+{
+    other.pool = nullptr;
+}
+
+PooledConnection& PooledConnection::operator=(PooledConnection&& other) noexcept
+{
+    if (this != &other)
+    {
+        giveBack();
+        pool = other.pool;
+        key = std::move(other.key);
+        conn = std::move(other.conn);
+        reusable = other.reusable;
+        other.pool = nullptr;
+    }
+    return *this;
+}
+
+void PooledConnection::discard()
+{
+    reusable = false;
+}
+
+void PooledConnection::giveBack()
+{
+    if (pool)
+        pool->checkin(key, std::move(conn), reusable);
+    pool = nullptr;
+    conn.reset();
+}
+
+ConnectionPool::ConnectionPool(size_t maxPerEndpointCount, std::chrono::seconds maxIdleTime, std::chrono::milliseconds validateAfter,
+                               std::chrono::milliseconds checkoutWait)
+    : maxPerEndpoint(maxPerEndpointCount), maxIdle(maxIdleTime), validateAfterIdle(validateAfter), checkoutTimeout(checkoutWait)
+{
+}
+
+ConnectionPool::~ConnectionPool()
+{
+    clear();
+}
+
+PooledConnection ConnectionPool::checkout(const DbEndpoint& endpoint)
+{
+    return checkoutFrom(endpoint, endpoint.getKey(), maxPerEndpoint);
+}
+
+PooledConnection ConnectionPool::checkoutReserved(const DbEndpoint& endpoint)
+{
+    return checkoutFrom(endpoint, endpoint.getKey() + "#reserved", RESERVED_PER_ENDPOINT);
+}
+
+PooledConnection ConnectionPool::checkoutFrom(const DbEndpoint& endpoint, const std::string& key, size_t limit)
+{
+    const Clock::time_point start = Clock::now();
+    std::vector<std::unique_ptr<sql::Connection>> toClose;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    evictIdleLocked(start, toClose);
+
+    Bucket& bucket = buckets[key];
+    if (!released.wait_for(lock, checkoutTimeout, [&]{ return !bucket.idle.empty() || bucket.inUse < limit; }))
+    {
+        // Wszystkie połączenia wypożyczone zbyt długo (np. eksport i import naraz) - błąd zamiast wiecznego czekania
+        const std::string message = "Connection pool exhausted: " + std::to_string(limit) + " connections to " +
+                                    endpoint.host + ":" + endpoint.port + " in use";
+        throw sql::SQLException(message.c_str());
+    }
+
+    while (!bucket.idle.empty())
+    {
+        IdleConnection candidate = std::move(bucket.idle.back());
+        bucket.idle.pop_back();
+        ++bucket.inUse;
+        lock.unlock();
+
+        // Ping tylko dla połączeń, które leżały dłużej - gorące połączenie wydajemy od razu
+        bool alive = true;
+        if (Clock::now() - candidate.since >= validateAfterIdle)
+        {
+            try
+            {
+                alive = candidate.conn->isValid();
+            }
+            catch (sql::SQLException&)
+            {
+                alive = false;
+            }
+        }
+
+        lock.lock();
+        if (alive)
+        {
+            recordCheckoutLocked(start, true);
+            return PooledConnection(this, key, std::move(candidate.conn));
+        }
+
+        --bucket.inUse;
+        ++stats.failedPings;
+        toClose.push_back(std::move(candidate.conn));
+    }
+
+    // Brak wolnego połączenia - nawiązujemy nowe poza blokadą
+    ++bucket.inUse;
+    lock.unlock();
+
+    std::unique_ptr<sql::Connection> conn;
+    try
+    {
+        conn = openConnection(endpoint);
+    }
+    catch (...)
+    {
+        lock.lock();
+        --bucket.inUse;
+        released.notify_all();
+        throw;
+    }
+
+    lock.lock();
+    recordCheckoutLocked(start, false);
+    return PooledConnection(this, key, std::move(conn));
+}
+
+void ConnectionPool::checkin(const std::string& key, std::unique_ptr<sql::Connection> conn, bool reusable)
+{
+    std::unique_ptr<sql::Connection> toClose;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = buckets.find(key);
+        if (it != buckets.end())
+        {
+            Bucket& bucket = it->second;
+            if (bucket.inUse > 0)
+                --bucket.inUse;
+
+            if (conn && reusable)
+                bucket.idle.push_back(IdleConnection{ std::move(conn), Clock::now() });
+        }
+        toClose = std::move(conn);
+    }
+    released.notify_all();
+}
+
+void ConnectionPool::evictIdle()
+{
+    std::vector<std::unique_ptr<sql::Connection>> toClose;
+    std::lock_guard<std::mutex> lock(mutex);
+    evictIdleLocked(Clock::now(), toClose);
+}
+
+void ConnectionPool::evictIdleLocked(Clock::time_point now, std::vector<std::unique_ptr<sql::Connection>>& toClose)
+{
+    for (auto& [key, bucket] : buckets)
+    {
+        auto& idle = bucket.idle;
+        for (auto it = idle.begin(); it != idle.end();)
+        {
+            if (now - it->since >= maxIdle)
+            {
+                toClose.push_back(std::move(it->conn));
+                it = idle.erase(it);
+                ++stats.evicted;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
+
+void ConnectionPool::clear()
+{
+    std::vector<std::unique_ptr<sql::Connection>> toClose;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& [key, bucket] : buckets)
+    {
+        for (auto& idleConn : bucket.idle)
+            toClose.push_back(std::move(idleConn.conn));
+        bucket.idle.clear();
+    }
+}
+
+void ConnectionPool::recordCheckoutLocked(Clock::time_point start, bool hit)
+{
+    const double waitMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    ++stats.checkouts;
+    if (hit)
+        ++stats.hits;
+    else
+        ++stats.misses;
+    stats.totalWaitMs += waitMs;
+    if (waitMs > stats.maxWaitMs)
+        stats.maxWaitMs = waitMs;
+}
+
+ConnectionPoolStats ConnectionPool::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ConnectionPoolStats snapshot = stats;
+    snapshot.idle = 0;
+    snapshot.inUse = 0;
+    for (const auto& [key, bucket] : buckets)
+    {
+        snapshot.idle += bucket.idle.size();
+        snapshot.inUse += bucket.inUse;
+    }
+    return snapshot;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <mariadb/conncpp.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Adres serwera i poświadczenia - klucz puli połączeń
+struct DbEndpoint
+{
+    std::string host;
+    std::string port;
+    std::string user;
+    std::string password;
+    // Protokół binarny: prepareStatement jako prawdziwe COM_STMT_PREPARE (useServerPrepStmts),
+    // wyniki zapytań przygotowanych przychodzą w postaci binarnej zamiast tekstu
+    bool serverPrepared = false;
+
+    std::string getUrl() const { return "tcp://" + host + ":" + port; }
+    std::string getKey() const;
+};
+
+// Nowe połączenie poza pulą (protokół wg endpoint.serverPrepared); błędy jako sql::SQLException
+std::unique_ptr<sql::Connection> openConnection(const DbEndpoint& endpoint);
+
+struct ConnectionPoolStats
+{
+    uint64_t checkouts = 0;
+    uint64_t hits = 0;        // wydano rozgrzane połączenie z puli
+    uint64_t misses = 0;      // trzeba było nawiązać nowe połączenie
+    uint64_t failedPings = 0; // martwe połączenia wyrzucone przy wydawaniu
+    uint64_t evicted = 0;     // zamknięte po zbyt długiej bezczynności
+    double totalWaitMs = 0.0; // czas spędzony w checkout() (czekanie + ewentualne łączenie)
+    double maxWaitMs = 0.0;
+    size_t idle = 0;
+    size_t inUse = 0;
+
+    double getHitRate() const { return checkouts ? static_cast<double>(hits) / static_cast<double>(checkouts) : 0.0; }
+    double getAverageWaitMs() const { return checkouts ? totalWaitMs / static_cast<double>(checkouts) : 0.0; }
+};
+
+class ConnectionPool;
+
+// Połączenie wypożyczone z puli - wraca do niej w destruktorze
+class PooledConnection
+{
+public:
+    PooledConnection() = default;
+    PooledConnection(ConnectionPool* owner, std::string endpointKey, std::unique_ptr<sql::Connection> connection);
+    ~PooledConnection();
+
+    PooledConnection(PooledConnection&& other) noexcept;
+    PooledConnection& operator=(PooledConnection&& other) noexcept;
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+
+    sql::Connection* get() const { return conn.get(); }
+    sql::Connection* operator->() const { return conn.get(); }
+    sql::Connection& operator*() const { return *conn; }
+    explicit operator bool() const { return conn != nullptr; }
+
+    // Połączenie w nieznanym stanie (np. przerwane zapytanie) - zamknij zamiast oddawać do puli
+    void discard();
+
+private:
+    void giveBack();
+
+    ConnectionPool* pool = nullptr;
+    std::string key;
+    std::unique_ptr<sql::Connection> conn;
+    bool reusable = true;
+};
+
+// Niewielka pula połączeń kluczowana adresem i poświadczeniami. Bezpieczna wątkowo.
+// Połączenia bezczynne dłużej niż validateAfterIdle są sprawdzane pingiem (isValid) przed wydaniem,
+// a bezczynne dłużej niż maxIdle - zamykane.
+class ConnectionPool
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ConnectionPool(size_t maxPerEndpoint = 4,
+                            std::chrono::seconds maxIdle = std::chrono::seconds(60),
+                            std::chrono::milliseconds validateAfterIdle = std::chrono::milliseconds(1000),
+                            std::chrono::milliseconds checkoutTimeout = std::chrono::milliseconds(10000));
+    ~ConnectionPool();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Czeka, gdy wszystkie połączenia do danego adresu są wypożyczone - najwyżej checkoutTimeout,
+    // potem sql::SQLException "pool exhausted". Błędy łączenia też jako sql::SQLException
+    PooledConnection checkout(const DbEndpoint& endpoint);
+    // Połączenie z osobnej, zarezerwowanej puli adresu (KILL QUERY) - przerwanie zapytania działa
+    // także wtedy, gdy zwykłe połączenia są wyczerpane
+    PooledConnection checkoutReserved(const DbEndpoint& endpoint);
+
+    void evictIdle();
+    void clear();
+
+    ConnectionPoolStats getStats() const;
+
+private:
+    friend class PooledConnection;
+
+    struct IdleConnection
+    {
+        std::unique_ptr<sql::Connection> conn;
+        Clock::time_point since;
+    };
+
+    struct Bucket
+    {
+        std::vector<IdleConnection> idle; // LIFO - najcieplejsze połączenie na końcu
+        size_t inUse = 0;
+    };
+
+    // Połączenia zarezerwowane na adres - KILL QUERY trwa chwilę, więc wystarcza jedno
+    static constexpr size_t RESERVED_PER_ENDPOINT = 1;
+
+    PooledConnection checkoutFrom(const DbEndpoint& endpoint, const std::string& key, size_t limit);
+    void checkin(const std::string& key, std::unique_ptr<sql::Connection> conn, bool reusable);
+    void evictIdleLocked(Clock::time_point now, std::vector<std::unique_ptr<sql::Connection>>& toClose);
+    void recordCheckoutLocked(Clock::time_point start, bool hit);
+
+    const size_t maxPerEndpoint;
+    const std::chrono::seconds maxIdle;
+    const std::chrono::milliseconds validateAfterIdle;
+    const std::chrono::milliseconds checkoutTimeout;
+
+    mutable std::mutex mutex;
+    std::condition_variable released;
+    std::unordered_map<std::string, Bucket> buckets;
+    ConnectionPoolStats stats;
+};
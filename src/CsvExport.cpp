@@ -0,0 +1,366 @@
+#include "CsvExport.h"
+#include "Trace.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "imgui/imgui.h"
+
+namespace
+{
+    enum class ExportFormat { Csv, Tsv };
+
+    struct ExportOptions
+    {
+        std::string path;
+        ExportFormat format = ExportFormat::Csv;
+        bool writeHeader = true;
+    };
+
+    constexpr int32_t FETCH_SIZE = 4096;             // wiersze pobierane z serwera naraz
+    constexpr size_t WRITE_BUFFER_BYTES = 1024 * 1024;
+
+    constexpr const char* FORMAT_LABELS[] = { "CSV (comma separated)", "TSV (tab separated)" };
+
+    // Bufor zapisu - jedno write() na megabajt zamiast na komórkę
+    class BufferedWriter
+    {
+    public:
+        explicit BufferedWriter(const std::string& path) : out(path, std::ios::binary | std::ios::trunc)
+        {
+            if (!out)
+                throw std::runtime_error("Cannot open file for writing: " + path);
+            buffer.reserve(WRITE_BUFFER_BYTES);
+        }
+
+        void put(char c)
+        {
+            buffer.push_back(c);
+            if (buffer.size() >= WRITE_BUFFER_BYTES)
+                flush();
+        }
+
+        void write(const char* data, size_t size)
+        {
+            if (buffer.size() + size > WRITE_BUFFER_BYTES)
+                flush();
+            if (size >= WRITE_BUFFER_BYTES)
+            {
+                writeOut(data, size);
+                return;
+            }
+            buffer.insert(buffer.end(), data, data + size);
+        }
+
+        void flush()
+        {
+            if (buffer.empty())
+                return;
+            writeOut(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+
+        uint64_t getBytesWritten() const { return written + buffer.size(); }
+
+    private:
+        void writeOut(const char* data, size_t size)
+        {
+            out.write(data, static_cast<std::streamsize>(size));
+            if (!out)
+                throw std::runtime_error("Write error (disk full?)");
+            written += size;
+        }
+
+        std::ofstream out;
+        std::vector<char> buffer;
+        uint64_t written = 0;
+    };
+
+    // CSV (RFC 4180): cudzysłowy tylko gdy potrzebne, NULL jako puste pole
+    void writeCsvField(BufferedWriter& writer, const char* data, size_t size)
+    {
+        bool needsQuotes = false;
+        for (size_t i = 0; i < size && !needsQuotes; ++i)
+        {
+            const char c = data[i];
+            needsQuotes = c == ',' || c == '"' || c == '\n' || c == '\r';
+        }
+
+        if (!needsQuotes)
+        {
+            writer.write(data, size);
+            return;
+        }
+
+        writer.put('"');
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (data[i] == '"')
+                writer.put('"');
+            writer.put(data[i]);
+        }
+        writer.put('"');
+    }
+
+    // TSV w konwencji MariaDB (SELECT ... INTO OUTFILE): escapowane \t \n \r \\, NULL jako \N
+    void writeTsvField(BufferedWriter& writer, const char* data, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            switch (data[i])
+            {
+                case '\t': writer.write("\\t", 2); break;
+                case '\n': writer.write("\\n", 2); break;
+                case '\r': writer.write("\\r", 2); break;
+                case '\\': writer.write("\\\\", 2); break;
+                default:   writer.put(data[i]); break;
+            }
+        }
+    }
+
+    void runExport(ConnectionPool& pool, DbEndpoint endpoint, std::string database, std::string tableName,
+                   ExportOptions options, std::shared_ptr<TaskProgress> progress)
+    {
+        TraceRecorder::setThreadName("CSV export");
+        TRACE_SCOPE_CAT("csv export", "task");
+
+        // Zapis do pliku tymczasowego - przerwany eksport nie zostawia niekompletnego pliku pod docelową nazwą
+        const std::string partPath = options.path + ".part";
+        bool completed = false;
+
+        try
+        {
+            progress->setStatus("Connecting...");
+            PooledConnection conn = pool.checkout(endpoint);
+            if (!database.empty())
+                conn->setSchema(database);
+
+            uint64_t connectionId = 0;
+            {
+                std::unique_ptr<sql::Statement> stmt(conn->createStatement());
+                std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT CONNECTION_ID()"));
+                if (res->next())
+                    connectionId = res->getUInt64(1);
+            }
+
+            BufferedWriter writer(partPath);
+            const char delimiter = options.format == ExportFormat::Csv ? ',' : '\t';
+            auto writeField = options.format == ExportFormat::Csv ? writeCsvField : writeTsvField;
+
+            // Strumieniowy odczyt: wiersze przychodzą w porcjach FETCH_SIZE, nic nie jest trzymane w pamięci
+            std::unique_ptr<sql::Statement> stmt(conn->createStatement());
+            stmt->setFetchSize(FETCH_SIZE);
+            progress->setStatus("Exporting...");
+            std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT * FROM `" + tableName + "`"));
+
+            sql::ResultSetMetaData* meta = res->getMetaData();
+            const uint32_t columnCount = meta->getColumnCount();
+
+            if (options.writeHeader)
+            {
+                for (uint32_t i = 1; i <= columnCount; ++i)
+                {
+                    if (i > 1)
+                        writer.put(delimiter);
+                    sql::SQLString name = meta->getColumnLabel(i);
+                    writeField(writer, name.c_str(), name.length());
+                }
+                writer.put('\n');
+            }
+
+            while (!progress->cancelRequested && res->next())
+            {
+                for (uint32_t i = 1; i <= columnCount; ++i)
+                {
+                    if (i > 1)
+                        writer.put(delimiter);
+
+                    const int32_t column = static_cast<int32_t>(i);
+                    if (res->isNull(column))
+                    {
+                        if (options.format == ExportFormat::Tsv)
+                            writer.write("\\N", 2);
+                        continue;
+                    }
+
+                    sql::SQLString value = res->getString(column);
+                    writeField(writer, value.c_str(), value.length());
+                }
+                writer.put('\n');
+
+                ++progress->rows;
+                progress->bytes.store(writer.getBytesWritten(), std::memory_order_relaxed);
+            }
+
+            if (progress->cancelRequested)
+            {
+                // Zamknięcie strumieniowego wyniku doczytałoby resztę tabeli - przerywamy zapytanie po stronie serwera
+                if (connectionId != 0)
+                {
+                    try
+                    {
+                        PooledConnection side = pool.checkoutReserved(endpoint);
+                        std::unique_ptr<sql::Statement> kill(side->createStatement());
+                        kill->execute("KILL QUERY " + std::to_string(connectionId));
+                    }
+                    catch (sql::SQLException& e)
+                    {
+                        std::cerr << "Failed to stop export query: " << e.what() << std::endl;
+                    }
+                }
+                conn.discard();
+                progress->setStatus("Cancelled");
+            }
+            else
+            {
+                writer.flush();
+                progress->bytes = writer.getBytesWritten();
+                completed = true;
+            }
+        }
+        catch (sql::SQLException& e)
+        {
+            progress->fail(e.what());
+        }
+        catch (const std::exception& e)
+        {
+            progress->fail(e.what());
+        }
+
+        if (completed)
+        {
+            std::remove(options.path.c_str());
+            if (std::rename(partPath.c_str(), options.path.c_str()) != 0)
+                progress->fail("Cannot rename " + partPath + " to " + options.path);
+            else
+                progress->setStatus("Done");
+        }
+        else
+        {
+            std::remove(partPath.c_str());
+        }
+
+        progress->finish();
+    }
+}
+
+CsvExporter::~CsvExporter()
+{
+    cancelAndWait();
+}
+
+void CsvExporter::open(const std::string& table)
+{
+    if (isRunning() && table != tableName)
+        return; // popup trwającego eksportu pokazuje jego tabelę
+
+    if (!isRunning() && table != tableName)
+        std::snprintf(pathBuf, sizeof(pathBuf), "%s.%s", table.c_str(), formatIndex == 0 ? "csv" : "tsv");
+
+    tableName = table;
+    openRequested = true;
+}
+
+void CsvExporter::cancelAndWait()
+{
+    if (progress)
+        progress->cancelRequested = true;
+    if (worker.joinable())
+        worker.join();
+}
+
+void CsvExporter::start(ConnectionPool& pool, const DbEndpoint& endpoint, const std::string& database)
+{
+    if (worker.joinable())
+        worker.join();
+
+    ExportOptions options;
+    options.path = pathBuf;
+    options.format = formatIndex == 0 ? ExportFormat::Csv : ExportFormat::Tsv;
+    options.writeHeader = writeHeader;
+
+    progress = std::make_shared<TaskProgress>();
+    worker = std::thread(runExport, std::ref(pool), endpoint, database, tableName, std::move(options), progress);
+}
+
+void CsvExporter::render(const DbEndpoint& endpoint, const std::string& database, ConnectionPool& pool)
+{
+    if (openRequested)
+    {
+        ImGui::OpenPopup(EXPORT_TABLE_POPUP_ID);
+        openRequested = false;
+    }
+
+    if (progress && progress->finished && worker.joinable())
+        worker.join();
+
+    const ImGuiViewport* vp = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(vp->GetCenter(), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+
+    if (!ImGui::BeginPopupModal(EXPORT_TABLE_POPUP_ID, nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove))
+        return;
+
+    const bool running = isRunning();
+
+    ImGui::Text("Export table: %s", tableName.c_str());
+    ImGui::Separator();
+
+    if (!running)
+    {
+        ImGui::PushItemWidth(360.0f);
+        ImGui::InputText("Output file", pathBuf, sizeof(pathBuf));
+        if (ImGui::BeginCombo("Format", FORMAT_LABELS[formatIndex]))
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                if (ImGui::Selectable(FORMAT_LABELS[i], i == formatIndex))
+                    formatIndex = i;
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::PopItemWidth();
+        ImGui::Checkbox("Write header row", &writeHeader);
+    }
+
+    if (progress)
+    {
+        ImGui::Text("%llu rows  |  %.0f rows/s  |  %.2f MB written  |  %.1f s",
+                    static_cast<unsigned long long>(progress->rows.load()),
+                    progress->getRowsPerSecond(),
+                    static_cast<double>(progress->bytes.load()) / (1024.0 * 1024.0),
+                    progress->getElapsedSeconds());
+
+        const std::string status = progress->getStatus();
+        if (!status.empty())
+            ImGui::TextDisabled("%s", status.c_str());
+
+        const std::string error = progress->getError();
+        if (!error.empty())
+            ImGui::TextColored(ImVec4(1, 0, 0, 1), "Błąd: %s", error.c_str());
+    }
+
+    ImGui::Separator();
+
+    if (running)
+    {
+        if (progress->cancelRequested)
+            ImGui::TextDisabled("Cancelling...");
+        else if (ImGui::Button("Cancel", ImVec2(120, 0)))
+            progress->cancelRequested = true;
+    }
+    else
+    {
+        if (ImGui::Button("Export", ImVec2(120, 0)) && pathBuf[0] != '\0')
+            start(pool, endpoint, database);
+
+        ImGui::SameLine();
+        if (ImGui::Button("Close", ImVec2(120, 0)))
+        {
+            progress.reset();
+            ImGui::CloseCurrentPopup();
+        }
+    }
+
+    ImGui::EndPopup();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ConnectionPool.h"
+#include "DbExecutor.h"
+#include "TaskProgress.h"
+#include <memory>
+#include <string>
+#include <thread>
+
+inline constexpr const char* EXPORT_TABLE_POPUP_ID = "Export Table##ExportTableModal";
+
+// Eksport tabeli do CSV/TSV bez wczytywania jej do TableData. Wiersze są czytane strumieniowo
+// (forward-only, fetch size) we własnym wątku z połączeniem z puli i od razu trafiają do buforowanego pliku.
+class CsvExporter
+{
+public:
+    CsvExporter() = default;
+    ~CsvExporter();
+
+    CsvExporter(const CsvExporter&) = delete;
+    CsvExporter& operator=(const CsvExporter&) = delete;
+
+    // Otwiera popup eksportu dla tabeli w następnej klatce
+    void open(const std::string& tableName);
+
+    void render(const DbEndpoint& endpoint, const std::string& database, ConnectionPool& pool);
+
+    bool isRunning() const { return progress && !progress->finished; }
+
+    // Przerywa trwający eksport i czeka na wątek
+    void cancelAndWait();
+
+private:
+    void start(ConnectionPool& pool, const DbEndpoint& endpoint, const std::string& database);
+
+    std::string tableName;
+    bool openRequested = false;
+
+    char pathBuf[512]{};
+    int formatIndex = 0; // 0 - CSV, 1 - TSV
+    bool writeHeader = true;
+
+    std::shared_ptr<TaskProgress> progress;
+    std::thread worker;
+};
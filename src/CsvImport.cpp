@@ -0,0 +1,664 @@
+#include "CsvImport.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include "imgui/imgui.h"
+
+// LOAD DATA w toku. KILL QUERY idzie pod blokadą i tylko przy niezerowym id, a wątek importu
+// zeruje id pod tą samą blokadą - spóźniony KILL nie trafi w cudze zapytanie po oddaniu połączenia do puli
+struct LoadDataKill
+{
+    std::mutex mutex;
+    uint64_t connectionId = 0;
+    bool killed = false;
+};
+
+namespace
+{
+    struct ImportOptions
+    {
+        std::string path;
+        char delimiter = ',';
+        bool hasHeader = true;
+        bool allowLoadData = true;
+    };
+
+    // Porcja trybu INSERT - ogranicza pamięć niezależnie od rozmiaru pliku
+    constexpr size_t CHUNK_MAX_ROWS = 5000;
+    constexpr size_t CHUNK_MAX_BYTES = 8 * 1024 * 1024;
+    constexpr size_t READ_BUFFER_BYTES = 1024 * 1024;
+
+    constexpr const char* DELIMITER_LABELS[] = { "Comma (,)", "Semicolon (;)", "Tab" };
+    constexpr char DELIMITERS[] = { ',', ';', '\t' };
+
+    // Strumieniowy parser CSV (RFC 4180): pola w cudzysłowach, "" jako cudzysłów, LF lub CRLF
+    class CsvReader
+    {
+    public:
+        CsvReader(std::istream& input, char fieldDelimiter)
+            : in(input), delimiter(fieldDelimiter), buffer(READ_BUFFER_BYTES)
+        {
+        }
+
+        // false na końcu pliku
+        bool readRecord(std::vector<std::string>& fields)
+        {
+            fields.clear();
+            std::string field;
+            bool inQuotes = false;
+            bool any = false;
+
+            for (;;)
+            {
+                const int next = get();
+                if (next < 0)
+                {
+                    if (!any)
+                        return false;
+                    fields.push_back(std::move(field));
+                    return true;
+                }
+
+                const char c = static_cast<char>(next);
+                any = true;
+
+                if (inQuotes)
+                {
+                    if (c == '"')
+                    {
+                        if (peek() == '"')
+                        {
+                            get();
+                            field += '"';
+                        }
+                        else
+                        {
+                            inQuotes = false;
+                        }
+                    }
+                    else
+                    {
+                        field += c;
+                    }
+                    continue;
+                }
+
+                if (c == '"' && field.empty())
+                    inQuotes = true;
+                else if (c == delimiter)
+                    fields.push_back(std::exchange(field, std::string{}));
+                else if (c == '\r')
+                    crlf = true;
+                else if (c == '\n')
+                {
+                    fields.push_back(std::move(field));
+                    return true;
+                }
+                else
+                    field += c;
+            }
+        }
+
+        uint64_t getBytesConsumed() const { return consumed; }
+        bool sawCrLf() const { return crlf; }
+
+    private:
+        bool fill()
+        {
+            if (!in)
+                return false;
+            in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            length = static_cast<size_t>(in.gcount());
+            position = 0;
+            return length > 0;
+        }
+
+        int peek()
+        {
+            if (position == length && !fill())
+                return -1;
+            return static_cast<unsigned char>(buffer[position]);
+        }
+
+        int get()
+        {
+            const int c = peek();
+            if (c >= 0)
+            {
+                ++position;
+                ++consumed;
+            }
+            return c;
+        }
+
+        std::istream& in;
+        char delimiter;
+        std::vector<char> buffer;
+        size_t position = 0;
+        size_t length = 0;
+        uint64_t consumed = 0;
+        bool crlf = false;
+    };
+
+    std::string toLower(std::string s)
+    {
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
+        return s;
+    }
+
+    // Literał SQL w apostrofach
+    std::string quoteLiteral(const std::string& text)
+    {
+        std::string quoted = "'";
+        for (char c : text)
+        {
+            if (c == '\\' || c == '\'')
+                quoted += '\\';
+            if (c == '\t')
+                quoted += "\\t";
+            else
+                quoted += c;
+        }
+        quoted += "'";
+        return quoted;
+    }
+
+    // Dla każdej kolumny CSV nazwa kolumny tabeli albo pusty napis (kolumna pomijana).
+    // Kolumny docelowe to te same, co w formularzu Add Row - bez auto_increment.
+    std::vector<std::string> mapColumns(const TableSchema& schema, const std::vector<std::string>& firstRecord, bool hasHeader)
+    {
+        std::vector<std::string> formColumns;
+        for (const auto& column : schema.columns)
+        {
+            if (!column.autoIncrement)
+                formColumns.push_back(column.name);
+        }
+
+        // BOM UTF-8 na początku pliku nie należy do nazwy pierwszej kolumny
+        std::vector<std::string> names = firstRecord;
+        if (hasHeader && !names.empty() && names[0].rfind("\xEF\xBB\xBF", 0) == 0)
+            names[0].erase(0, 3);
+
+        std::vector<std::string> mapping(names.size());
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            if (hasHeader)
+            {
+                const std::string wanted = toLower(names[i]);
+                for (const auto& name : formColumns)
+                {
+                    if (toLower(name) == wanted)
+                    {
+                        mapping[i] = name;
+                        break;
+                    }
+                }
+            }
+            else if (i < formColumns.size())
+            {
+                mapping[i] = formColumns[i];
+            }
+        }
+
+        if (std::all_of(mapping.begin(), mapping.end(), [](const std::string& name){ return name.empty(); }))
+            throw std::runtime_error("No CSV column matches a column of table " + schema.name);
+        return mapping;
+    }
+
+    // Odmowa samego LOAD DATA LOCAL - tylko po niej wolno przejść na INSERT. Inny błąd (duplikat klucza,
+    // dane w trybie strict, zerwane połączenie) mógł zostawić część wierszy i INSERT wstawiłby je ponownie
+    constexpr int ER_NOT_ALLOWED_COMMAND = 1148;            // serwer: local_infile wyłączone
+    constexpr int CR_LOAD_DATA_LOCAL_INFILE_REJECTED = 2068; // konektor: LOCAL INFILE wyłączone po stronie klienta
+
+    bool isLocalInfileRefused(int errorCode)
+    {
+        return errorCode == ER_NOT_ALLOWED_COMMAND || errorCode == CR_LOAD_DATA_LOCAL_INFILE_REJECTED;
+    }
+
+    bool isLocalInfileEnabled(sql::Connection& conn)
+    {
+        std::unique_ptr<sql::Statement> stmt(conn.createStatement());
+        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT @@local_infile"));
+        return res->next() && res->getInt(1) != 0;
+    }
+
+    // LOAD DATA LOCAL INFILE - serwer parsuje plik sam; puste pole kolumny z wartością domyślną daje DEFAULT, jak w formularzu
+    uint64_t loadDataLocal(sql::Connection& conn, const TableSchema& schema, const ImportOptions& options,
+                           const std::vector<std::string>& mapping, bool crlf)
+    {
+        std::string columnList;
+        std::string setList;
+        for (size_t i = 0; i < mapping.size(); ++i)
+        {
+            if (!columnList.empty())
+                columnList += ", ";
+
+            const ColumnInfo* column = mapping[i].empty() ? nullptr : schema.findColumn(mapping[i]);
+            if (!column)
+            {
+                columnList += "@skip";
+                continue;
+            }
+
+            if (!column->defaultValue)
+            {
+                columnList += "`" + column->name + "`";
+                continue;
+            }
+
+            const std::string var = "@c" + std::to_string(i);
+            columnList += var;
+            if (!setList.empty())
+                setList += ", ";
+            setList += "`" + column->name + "` = IF(" + var + " = '', DEFAULT(`" + column->name + "`), " + var + ")";
+        }
+
+        std::string sql = "LOAD DATA LOCAL INFILE " + quoteLiteral(options.path) +
+                          " INTO TABLE `" + schema.name + "` CHARACTER SET utf8mb4" +
+                          " FIELDS TERMINATED BY " + quoteLiteral(std::string(1, options.delimiter)) +
+                          " OPTIONALLY ENCLOSED BY '\"' ESCAPED BY ''" +
+                          " LINES TERMINATED BY " + (crlf ? "'\\r\\n'" : "'\\n'");
+        if (options.hasHeader)
+            sql += " IGNORE 1 LINES";
+        sql += " (" + columnList + ")";
+        if (!setList.empty())
+            sql += " SET " + setList;
+
+        std::unique_ptr<sql::Statement> stmt(conn.createStatement());
+        stmt->execute(sql);
+        return static_cast<uint64_t>(std::max<int64_t>(stmt->getLargeUpdateCount(), 0));
+    }
+
+    // Tryb zapasowy: porcje wielowierszowych INSERT, pamięć ograniczona rozmiarem jednej porcji
+    void insertInChunks(sql::Connection& conn, const TableSchema& schema, CsvReader& reader,
+                        std::vector<std::string> firstRecord, bool firstIsData,
+                        const std::vector<std::string>& mapping, TaskProgress& progress)
+    {
+        std::vector<std::string> targetColumns;
+        std::vector<size_t> sourceIndex;
+        for (size_t i = 0; i < mapping.size(); ++i)
+        {
+            if (!mapping[i].empty())
+            {
+                targetColumns.push_back(mapping[i]);
+                sourceIndex.push_back(i);
+            }
+        }
+
+        const size_t maxPacket = queryMaxAllowedPacket(conn);
+        std::vector<std::vector<std::string>> chunk;
+        size_t chunkBytes = 0;
+
+        auto flush = [&]
+        {
+            if (chunk.empty())
+                return;
+            progress.rows += insertRows(conn, schema, targetColumns, chunk, maxPacket);
+            chunk.clear();
+            chunkBytes = 0;
+        };
+
+        std::vector<std::string> record = std::move(firstRecord);
+        bool haveRecord = firstIsData || reader.readRecord(record);
+        while (haveRecord)
+        {
+            if (progress.cancelRequested)
+                return;
+
+            // Pusta linia - pomijamy
+            if (!(record.size() == 1 && record[0].empty()))
+            {
+                std::vector<std::string> row;
+                row.reserve(sourceIndex.size());
+                for (size_t index : sourceIndex)
+                {
+                    row.push_back(index < record.size() ? std::move(record[index]) : std::string{});
+                    chunkBytes += row.back().size();
+                }
+                chunk.push_back(std::move(row));
+
+                if (chunk.size() >= CHUNK_MAX_ROWS || chunkBytes >= CHUNK_MAX_BYTES)
+                    flush();
+            }
+
+            progress.bytes.store(reader.getBytesConsumed(), std::memory_order_relaxed);
+            haveRecord = reader.readRecord(record);
+        }
+
+        flush();
+        progress.bytes.store(reader.getBytesConsumed());
+    }
+
+    // Ciało wątku przerywającego LOAD DATA. Połączenie pomocnicze bez blokady - łączenie może trwać
+    void killLoadData(ConnectionPool& pool, DbEndpoint endpoint, std::shared_ptr<LoadDataKill> kill)
+    {
+        TraceRecorder::setThreadName("CSV import cancel");
+        {
+            std::lock_guard<std::mutex> lock(kill->mutex);
+            if (kill->connectionId == 0)
+                return;
+        }
+
+        try
+        {
+            PooledConnection side = pool.checkoutReserved(endpoint);
+            std::lock_guard<std::mutex> lock(kill->mutex);
+            if (kill->connectionId == 0)
+                return; // LOAD DATA zdążył się skończyć
+            std::unique_ptr<sql::Statement> stmt(side->createStatement());
+            stmt->execute("KILL QUERY " + std::to_string(kill->connectionId));
+            kill->killed = true;
+        }
+        catch (sql::SQLException& e)
+        {
+            std::cerr << "Failed to cancel import: " << e.what() << std::endl;
+        }
+    }
+
+    // Ciało wątku importu
+    void runImport(ConnectionPool& pool, DbEndpoint endpoint, std::string database, std::shared_ptr<const TableSchema> schema,
+                   ImportOptions options, std::shared_ptr<TaskProgress> progress, std::shared_ptr<LoadDataKill> kill)
+    {
+        TraceRecorder::setThreadName("CSV import");
+        TRACE_SCOPE_CAT("csv import", "task");
+        try
+        {
+            std::ifstream in(options.path, std::ios::binary | std::ios::ate);
+            if (!in)
+                throw std::runtime_error("Cannot open file: " + options.path);
+            progress->totalBytes = static_cast<uint64_t>(in.tellg());
+            in.seekg(0);
+
+            CsvReader reader(in, options.delimiter);
+            std::vector<std::string> firstRecord;
+            if (!reader.readRecord(firstRecord))
+            {
+                progress->setStatus("File is empty");
+                progress->finish();
+                return;
+            }
+            const std::vector<std::string> mapping = mapColumns(*schema, firstRecord, options.hasHeader);
+
+            progress->setStatus("Connecting...");
+            PooledConnection conn = pool.checkout(endpoint);
+            if (!database.empty())
+                conn->setSchema(database);
+
+            bool loaded = false;
+            if (options.allowLoadData && isLocalInfileEnabled(*conn))
+            {
+                uint64_t connectionId = 0;
+                {
+                    std::unique_ptr<sql::Statement> stmt(conn->createStatement());
+                    std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT CONNECTION_ID()"));
+                    if (res->next())
+                        connectionId = res->getUInt64(1);
+                }
+                {
+                    // Anulowanie przed tym miejscem nie widziało id - LOAD DATA nie może już ruszyć
+                    std::lock_guard<std::mutex> lock(kill->mutex);
+                    if (progress->cancelRequested)
+                        throw sql::SQLException("Cancelled");
+                    kill->connectionId = connectionId;
+                }
+
+                // Serwer nie raportuje postępu LOAD DATA LOCAL (nie zna rozmiaru pliku) - liczniki dopiero na końcu
+                progress->setStatus("Server is loading the file (LOAD DATA LOCAL INFILE)...");
+                progress->countersLive = false;
+                std::string loadError;
+                int loadErrorCode = 0;
+                try
+                {
+                    progress->rows = loadDataLocal(*conn, *schema, options, mapping, reader.sawCrLf());
+                    progress->bytes = progress->totalBytes.load();
+                    loaded = true;
+                }
+                catch (sql::SQLException& e)
+                {
+                    loadError = e.what();
+                    loadErrorCode = e.getErrorCode();
+                }
+                progress->countersLive = true;
+
+                {
+                    std::lock_guard<std::mutex> lock(kill->mutex);
+                    kill->connectionId = 0;
+                    // Po KILL stan sesji serwera jest niepewny - połączenie nie wraca do puli
+                    if (kill->killed)
+                        conn.discard();
+                }
+
+                if (!loaded)
+                {
+                    if (progress->cancelRequested || !isLocalInfileRefused(loadErrorCode))
+                        throw sql::SQLException(loadError.c_str());
+                    std::cerr << "LOAD DATA LOCAL INFILE failed, falling back to INSERT: " << loadError << std::endl;
+                }
+            }
+
+            if (!loaded)
+            {
+                progress->setStatus("Inserting rows...");
+                insertInChunks(*conn, *schema, reader, std::move(firstRecord), !options.hasHeader, mapping, *progress);
+            }
+
+            progress->setStatus(progress->cancelRequested ? "Cancelled - rows inserted so far were kept" : "Done");
+        }
+        catch (sql::SQLException& e)
+        {
+            progress->fail(progress->cancelRequested ? "Cancelled" : e.what());
+        }
+        catch (const std::exception& e)
+        {
+            progress->fail(e.what());
+        }
+
+        progress->finish();
+    }
+}
+
+CsvImporter::~CsvImporter()
+{
+    cancelAndWait();
+}
+
+void CsvImporter::open(const std::string& table)
+{
+    if (isRunning() && table != tableName)
+        return; // popup trwającego importu pokazuje jego tabelę
+
+    tableName = table;
+    openRequested = true;
+}
+
+void CsvImporter::cancelAndWait()
+{
+    if (progress)
+        progress->cancelRequested = true;
+    if (killer.joinable())
+        killer.join();
+    if (worker.joinable())
+        worker.join();
+}
+
+void CsvImporter::start(DbExecutor& db, const DbEndpoint& endpoint, const std::string& database)
+{
+    if (killer.joinable())
+        killer.join();
+    if (worker.joinable())
+        worker.join();
+
+    ImportOptions options;
+    options.path = pathBuf;
+    options.delimiter = DELIMITERS[delimiterIndex];
+    options.hasHeader = hasHeader;
+    options.allowLoadData = allowLoadData;
+
+    progress = std::make_shared<TaskProgress>();
+    loadDataKill = std::make_shared<LoadDataKill>();
+    completionHandled = false;
+
+    worker = std::thread(runImport, std::ref(db.pool()), endpoint, database, schema, std::move(options), progress, loadDataKill);
+}
+
+void CsvImporter::requestCancel(DbExecutor& db, const DbEndpoint& endpoint)
+{
+    progress->cancelRequested = true;
+
+    // LOAD DATA nie da się przerwać po stronie klienta - KILL QUERY z osobnego połączenia,
+    // własnym wątkiem zamiast kolejki DbExecutor, żeby nie czekał za innymi zadaniami
+    if (killer.joinable())
+        killer.join();
+    killer = std::thread(killLoadData, std::ref(db.pool()), endpoint, loadDataKill);
+}
+
+void CsvImporter::render(DbExecutor& db, const DbEndpoint& endpoint, const std::string& database, const RowsChangedCallback& onRowsChanged)
+{
+    if (openRequested)
+    {
+        ImGui::OpenPopup(IMPORT_CSV_POPUP_ID);
+        openRequested = false;
+    }
+
+    // Zakończenie obsługujemy niezależnie od popupu - dane tabeli trzeba odświeżyć także po jego zamknięciu
+    if (progress && progress->finished && !completionHandled)
+    {
+        completionHandled = true;
+        if (killer.joinable())
+            killer.join();
+        if (worker.joinable())
+            worker.join();
+        if (progress->rows > 0 && onRowsChanged)
+            onRowsChanged(tableName);
+    }
+
+    const ImGuiViewport* vp = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(vp->GetCenter(), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+
+    if (!ImGui::BeginPopupModal(IMPORT_CSV_POPUP_ID, nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove))
+        return;
+
+    const bool running = isRunning();
+
+    // Kolumny docelowe z SchemaCache, jak w formularzu Add Row
+    if (ImGui::IsWindowAppearing() && !running)
+    {
+        const uint64_t request = ++formRequest;
+        schema.reset();
+        schemaError.clear();
+        progress.reset();
+
+        db.submit(
+            [table = tableName](DbSession& session)
+            {
+                auto tableSchema = session.schema().getTable(session.connection(), table);
+                if (!tableSchema)
+                    throw std::runtime_error("Unknown table: " + table);
+                return tableSchema;
+            },
+            [this, request](DbResult<std::shared_ptr<const TableSchema>>& result)
+            {
+                if (request != formRequest)
+                    return;
+                if (!result.ok())
+                    schemaError = result.error;
+                else
+                    schema = result.value;
+            });
+    }
+
+    ImGui::Text("Import into table: %s", tableName.c_str());
+
+    if (schema)
+    {
+        std::string columnList;
+        for (const auto& column : schema->columns)
+        {
+            if (column.autoIncrement)
+                continue;
+            if (!columnList.empty())
+                columnList += ", ";
+            columnList += column.name;
+        }
+        ImGui::TextDisabled("Columns: %s", columnList.c_str());
+    }
+    else if (schemaError.empty())
+    {
+        ImGui::TextDisabled("Loading columns...");
+    }
+
+    ImGui::Separator();
+
+    if (!running)
+    {
+        ImGui::PushItemWidth(360.0f);
+        ImGui::InputText("CSV file", pathBuf, sizeof(pathBuf));
+        if (ImGui::BeginCombo("Delimiter", DELIMITER_LABELS[delimiterIndex]))
+        {
+            for (int i = 0; i < static_cast<int>(std::size(DELIMITERS)); ++i)
+            {
+                if (ImGui::Selectable(DELIMITER_LABELS[i], i == delimiterIndex))
+                    delimiterIndex = i;
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::PopItemWidth();
+        ImGui::Checkbox("First line is a header (match columns by name)", &hasHeader);
+        ImGui::Checkbox("Use LOAD DATA LOCAL INFILE when the server allows it", &allowLoadData);
+    }
+
+    if (progress)
+    {
+        if (progress->countersLive)
+        {
+            const float fraction = progress->getFraction();
+            ImGui::ProgressBar(fraction < 0.0f ? 0.0f : fraction, ImVec2(360.0f, 0.0f));
+            ImGui::Text("%llu rows  |  %.0f rows/s  |  %.2f MB/s  |  %.1f s",
+                        static_cast<unsigned long long>(progress->rows.load()),
+                        progress->getRowsPerSecond(),
+                        progress->getBytesPerSecond() / (1024.0 * 1024.0),
+                        progress->getElapsedSeconds());
+        }
+        else
+        {
+            ImGui::ProgressBar(0.0f, ImVec2(360.0f, 0.0f), "no live progress");
+            ImGui::Text("%.1f s  |  the server does not report progress of LOAD DATA LOCAL INFILE;", progress->getElapsedSeconds());
+            ImGui::TextDisabled("row count and throughput are shown when it finishes");
+        }
+
+        const std::string status = progress->getStatus();
+        if (!status.empty())
+            ImGui::TextDisabled("%s", status.c_str());
+    }
+
+    const std::string error = progress ? progress->getError() : schemaError;
+    if (!error.empty())
+        ImGui::TextColored(ImVec4(1, 0, 0, 1), "Błąd: %s", error.c_str());
+
+    ImGui::Separator();
+
+    if (running)
+    {
+        if (progress->cancelRequested)
+            ImGui::TextDisabled("Cancelling...");
+        else if (ImGui::Button("Cancel", ImVec2(120, 0)))
+            requestCancel(db, endpoint);
+    }
+    else
+    {
+        if (ImGui::Button("Import", ImVec2(120, 0)) && schema && pathBuf[0] != '\0')
+            start(db, endpoint, database);
+
+        ImGui::SameLine();
+        if (ImGui::Button("Close", ImVec2(120, 0)))
+            ImGui::CloseCurrentPopup();
+    }
+
+    ImGui::EndPopup();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ConnectionPool.h"
+#include "DbExecutor.h"
+#include "TableOperations.h"
+#include "TaskProgress.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+inline constexpr const char* IMPORT_CSV_POPUP_ID = "Import CSV##ImportCsvModal";
+
+struct LoadDataKill;
+
+// Import pliku CSV do tabeli. Plik jest czytany strumieniowo we własnym wątku z połączeniem z puli,
+// więc wielogigabajtowy import nie blokuje ani UI, ani kolejki DbExecutor.
+// Najpierw LOAD DATA LOCAL INFILE (gdy serwer pozwala), w przeciwnym razie porcje wielowierszowych INSERT.
+class CsvImporter
+{
+public:
+    CsvImporter() = default;
+    ~CsvImporter();
+
+    CsvImporter(const CsvImporter&) = delete;
+    CsvImporter& operator=(const CsvImporter&) = delete;
+
+    // Otwiera popup importu dla tabeli w następnej klatce
+    void open(const std::string& tableName);
+
+    // Rysuje popup; endpoint i baza służą do wypożyczenia połączenia dla wątku importu
+    void render(DbExecutor& db, const DbEndpoint& endpoint, const std::string& database, const RowsChangedCallback& onRowsChanged);
+
+    bool isRunning() const { return progress && !progress->finished; }
+
+    // Przerywa trwający import i czeka na wątek
+    void cancelAndWait();
+
+private:
+    void start(DbExecutor& db, const DbEndpoint& endpoint, const std::string& database);
+    void requestCancel(DbExecutor& db, const DbEndpoint& endpoint);
+
+    std::string tableName;
+    bool openRequested = false;
+
+    char pathBuf[512]{};
+    int delimiterIndex = 0;
+    bool hasHeader = true;
+    bool allowLoadData = true;
+
+    uint64_t formRequest = 0; // odrzuca schemat wczytany dla poprzednio otwartego popupu
+    std::shared_ptr<const TableSchema> schema;
+    std::string schemaError;
+
+    std::shared_ptr<TaskProgress> progress;
+    std::shared_ptr<LoadDataKill> loadDataKill; // do KILL QUERY podczas LOAD DATA
+    std::thread worker;
+    std::thread killer; // wysyła KILL QUERY - UI nie czeka na połączenie z serwerem
+    bool completionHandled = true;
+};
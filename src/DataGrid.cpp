@@ -0,0 +1,192 @@
+#include "DataGrid.h"
+#include <algorithm>
+#include <cfloat>
+#include <iostream>
+#include "imgui/imgui.h"
+
+// Zapytanie z filtrem dopiero po przerwie w pisaniu - nie po każdym znaku
+static constexpr double FILTER_DEBOUNCE_SECONDS = 0.3;
+
+const char* ICON_FA_TRASH = "\xef\x80\x8d";
+const char* ICON_FA_PEN   = "\xef\x81\x84";
+
+// Akcja przycisku wiersza - bez klucza głównego wiersza nie da się wskazać
+static void requestRowAction(DataGrid::Result& result, DataGrid::RowAction action, const RowRef& row, int pkIndex,
+                             const std::string& tableName, const std::string& pkColumn)
+{
+    if (pkIndex < 0)
+    {
+        std::cerr << "Cannot " << (action == DataGrid::RowAction::Edit ? "update" : "delete")
+                  << " row: primary key column not found in headers for table " << tableName << " (pk=" << pkColumn << ")\n";
+        return;
+    }
+
+    result.action = action;
+    result.pkValue = row.getCellString(static_cast<size_t>(pkIndex));
+}
+
+DataGrid::Result DataGrid::render(const std::string& gridId, const std::vector<std::string>& headers, const std::string& pkColumn,
+                                  size_t rowCount, const std::function<RowRef(size_t)>& rowAt, TableQuery& query)
+{
+    Result result;
+    VisibleRows& visible = result.visible;
+    if (headers.empty())
+    {
+        ImGui::TextUnformatted("There is nothing to show");
+        return result;
+    }
+
+    const int dataColumnCount = static_cast<int>(headers.size());
+    const int totalColumns = dataColumnCount + 1;
+
+    if (filterBufs.size() != headers.size())
+        filterBufs.assign(headers.size(), std::array<char, 128>{});
+
+    // Osobne ID tabeli ImGui dla każdej tabeli bazy - własne sortowanie i szerokości kolumn
+    ImGui::PushID(gridId.c_str());
+    if (ImGui::BeginTable("DataTable", totalColumns,
+                          ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_ScrollY
+                        | ImGuiTableFlags_Sortable | ImGuiTableFlags_SortTristate))
+    {
+        // Nagłówki i wiersz filtrów zostają na górze przy przewijaniu
+        ImGui::TableSetupScrollFreeze(0, 2);
+        for (int c = 0; c < dataColumnCount; ++c)
+            ImGui::TableSetupColumn(headers[c].c_str(), ImGuiTableColumnFlags_None, 0.0f, static_cast<ImGuiID>(c));
+        ImGui::TableSetupColumn("Actions", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_NoSort, 120.0f);
+
+        // Kliknięcie nagłówka zmienia ORDER BY - sortuje serwer, nie klient.
+        // Stan czytany co klatkę: ImGui pamięta sortowanie tabeli, a zapytanie zeruje się przy zmianie tabeli.
+        if (ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs())
+        {
+            if (sortSpecs->SpecsCount > 0 && sortSpecs->Specs[0].ColumnUserID < headers.size())
+            {
+                query.sortColumn = headers[sortSpecs->Specs[0].ColumnUserID];
+                query.descending = sortSpecs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+            }
+            else
+            {
+                query.sortColumn.clear();
+                query.descending = false;
+            }
+            sortSpecs->SpecsDirty = false;
+        }
+
+        ImGui::TableHeadersRow();
+
+        // Wiersz filtrów - składnia w podpowiedzi, warunki trafiają do WHERE jako parametry
+        ImGui::TableNextRow();
+        for (int c = 0; c < dataColumnCount; ++c)
+        {
+            ImGui::TableSetColumnIndex(c);
+            ImGui::PushID(c);
+            ImGui::SetNextItemWidth(-FLT_MIN);
+            if (ImGui::InputTextWithHint("##filter", "filter", filterBufs[c].data(), filterBufs[c].size()))
+            {
+                filterPending = true;
+                filterEditTime = ImGui::GetTime();
+            }
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("abc - starts with, ~abc - contains\n=, !=, <, <=, >, >= - comparison\nnull / !null");
+            ImGui::PopID();
+        }
+
+        if (filterPending && ImGui::GetTime() - filterEditTime >= FILTER_DEBOUNCE_SECONDS)
+        {
+            filterPending = false;
+            query.filters.clear();
+            for (int c = 0; c < dataColumnCount; ++c)
+            {
+                if (filterBufs[c][0] != '\0')
+                    query.filters.push_back(ColumnFilter{ headers[c], filterBufs[c].data() });
+            }
+        }
+
+        int pkIndex = -1;
+        if (!pkColumn.empty())
+        {
+            for (int i = 0; i < dataColumnCount; ++i)
+            {
+                if (headers[i] == pkColumn)
+                {
+                    pkIndex = i;
+                    break;
+                }
+            }
+        }
+
+        // Stała wysokość wiersza - clipper nie musi mierzyć pierwszego wiersza, a zakres widoczny jest dokładny
+        const float rowHeight = ImGui::GetFrameHeight();
+        visible.first = rowCount;
+        CellBuffer cellBuffer;
+
+        // Rysowane są tylko wiersze w widocznym obszarze
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(rowCount), rowHeight);
+        while (clipper.Step())
+        {
+            for (int rowIndex = clipper.DisplayStart; rowIndex < clipper.DisplayEnd; ++rowIndex)
+            {
+                visible.first = std::min(visible.first, static_cast<size_t>(rowIndex));
+                visible.last  = std::max(visible.last, static_cast<size_t>(rowIndex) + 1);
+
+                ImGui::TableNextRow(ImGuiTableRowFlags_None, rowHeight);
+                ImGui::PushID(rowIndex);
+
+                const RowRef row = rowAt(static_cast<size_t>(rowIndex));
+                if (!row)
+                {
+                    // Strona jeszcze nie dotarła z bazy
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::TextDisabled("...");
+                    ImGui::PopID();
+                    continue;
+                }
+
+                for (int c = 0; c < dataColumnCount; ++c)
+                {
+                    ImGui::TableSetColumnIndex(c);
+                    if (row.isNull(static_cast<size_t>(c)))
+                    {
+                        ImGui::TextDisabled("NULL");
+                        continue;
+                    }
+
+                    // Tekst wskazuje bezpośrednio do areny, liczby i daty są formatowane dopiero tutaj - tylko dla widocznych wierszy
+                    std::string_view cell = row.getCell(static_cast<size_t>(c), cellBuffer);
+                    ImGui::TextUnformatted(cell.data(), cell.data() + cell.size());
+                }
+
+                ImGui::TableSetColumnIndex(dataColumnCount);
+
+                float columnWidth = ImGui::GetColumnWidth(dataColumnCount);
+                float buttonWidth = 25.0f;
+                float offset = (columnWidth - 2 * buttonWidth) / 3.0f;
+
+                ImGui::SetCursorPosX(ImGui::GetCursorPosX() + offset);
+
+                if (ImGui::SmallButton(ICON_FA_PEN))
+                    requestRowAction(result, RowAction::Edit, row, pkIndex, gridId, pkColumn);
+
+                ImGui::SameLine();
+                ImGui::SetCursorPosX(ImGui::GetCursorPosX() + offset);
+
+                if (ImGui::SmallButton(ICON_FA_TRASH))
+                    requestRowAction(result, RowAction::Delete, row, pkIndex, gridId, pkColumn);
+
+                ImGui::PopID();
+            }
+        }
+        clipper.End();
+
+        ImGui::EndTable();
+    }
+    ImGui::PopID();
+
+    return result;
+}
+
+void DataGrid::reset()
+{
+    filterBufs.clear();
+    filterPending = false;
+}
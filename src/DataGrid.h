@@ -0,0 +1,55 @@
+#pragma once
+
+#include "TableData.h"
+#include "TableQuery.h"
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Siatka danych tabeli: nagłówki z sortowaniem po stronie serwera, wiersz filtrów i wiersze rysowane przez clipper.
+// Nie zna bazy ani okna - sortowanie i filtry trafiają do TableQuery, a przyciski wiersza wracają w Result.
+// Wymaga tylko kontekstu ImGui, więc da się ją rysować także bez backendu (benchmark).
+class DataGrid
+{
+public:
+    // Zakres wierszy [first, last) narysowany w tej klatce przez clipper
+    struct VisibleRows
+    {
+        size_t first = 0;
+        size_t last = 0;
+    };
+
+    enum class RowAction
+    {
+        None,
+        Edit,
+        Delete
+    };
+
+    struct Result
+    {
+        VisibleRows visible;
+        RowAction action = RowAction::None;
+        std::string pkValue; // wiersz, którego dotyczy akcja
+    };
+
+    // gridId rozróżnia stan ImGui (sortowanie, szerokości kolumn) - np. nazwa tabeli bazy.
+    // Przyciski edycji i usuwania działają tylko z kolumną klucza głównego wśród nagłówków.
+    Result render(const std::string& gridId, const std::vector<std::string>& headers, const std::string& pkColumn,
+                  size_t rowCount, const std::function<RowRef(size_t)>& rowAt, TableQuery& query);
+
+    // Inna tabela - pola filtrów zaczynają od zera
+    void reset();
+    // Filtr edytowany, zapytanie dopiero po FILTER_DEBOUNCE_SECONDS
+    bool isFilterPending() const { return filterPending; }
+
+private:
+    std::vector<std::array<char, 128>> filterBufs; // po jednym polu filtra na kolumnę
+    bool filterPending = false;
+    double filterEditTime = 0.0;
+};
+
+// Icons
+extern const char* ICON_FA_TRASH;
+extern const char* ICON_FA_PEN;
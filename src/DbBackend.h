@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ConnectionPool.h"
+#include "TableData.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Dostęp do bazy niezależny od konektora: połączenie, zapytanie, zapytanie przygotowane i odczyt wyniku.
+// Ścieżka pobierania (TableFetch) korzysta tylko z tej warstwy, więc ta sama pętla działa na MariaDB
+// (MariaDbBackend) i na syntetycznych tabelach w pamięci (FakeBackend) - bez sieci i serwera.
+
+// Kolumna wyniku: nazwa i sposób przechowywania w TableData (z metadanych wyniku)
+struct ResultColumn
+{
+    std::string name;
+    ColumnType type = ColumnType::Text;
+    int scale = 0;
+};
+
+// Wynik czytany wiersz po wierszu, tylko do przodu. Kolumny indeksowane od 0.
+// Wartość czytana metodą zgodną z typem kolumny: Int - getInt64, UInt - getUInt64,
+// Double i Float - getDouble, pozostałe (tekst, DECIMAL, daty) - getText.
+class RowSource
+{
+public:
+    virtual ~RowSource() = default;
+
+    virtual const std::vector<ResultColumn>& getColumns() const = 0;
+    virtual bool next() = 0;
+
+    virtual bool isNull(size_t column) = 0;
+    virtual int64_t getInt64(size_t column) = 0;
+    virtual uint64_t getUInt64(size_t column) = 0;
+    virtual double getDouble(size_t column) = 0;
+    // Ważne do następnego next() albo getText()
+    virtual std::string_view getText(size_t column) = 0;
+};
+
+// Otwarte połączenie. Błędy są rzucane (MariaDB: sql::SQLException).
+class DbConnection
+{
+public:
+    virtual ~DbConnection() = default;
+
+    // Zapytanie bez parametrów
+    virtual std::unique_ptr<RowSource> query(const std::string& sql) = 0;
+    // Zapytanie przygotowane z parametrami tekstowymi; fetchSize > 0 - wynik czytany z serwera partiami zamiast buforowany w całości
+    virtual std::unique_ptr<RowSource> execute(const std::string& sql, const std::vector<std::string>& params, size_t fetchSize = 0) = 0;
+    // INSERT / UPDATE / DELETE - liczba zmienionych wierszy
+    virtual uint64_t executeUpdate(const std::string& sql, const std::vector<std::string>& params) = 0;
+};
+
+class DbBackend
+{
+public:
+    virtual ~DbBackend() = default;
+
+    // database "" - bez wybranej bazy
+    virtual std::unique_ptr<DbConnection> connect(const DbEndpoint& endpoint, const std::string& database) = 0;
+};
@@ -0,0 +1,225 @@
+#include "DbExecutor.h"
+#include "Trace.h"
+#include <iostream>
+
+void CancelToken::cancel()
+{
+    if (cancelled.exchange(true))
+        return;
+    executor->requestKill(*this);
+}
+
+bool DbSession::killQuery()
+{
+    if (!conn || connectionId == 0)
+        return false;
+
+    try
+    {
+        TRACE_SCOPE_CAT("KILL QUERY", "db");
+        PooledConnection side = connPool.checkoutReserved(endpoint);
+        std::unique_ptr<sql::Statement> stmt(side->createStatement());
+        stmt->execute("KILL QUERY " + std::to_string(connectionId));
+    }
+    catch (sql::SQLException& e)
+    {
+        std::cerr << "Cannot cancel query: " << e.what() << std::endl;
+        return false;
+    }
+    conn.discard();
+    return true;
+}
+
+void DbSession::reconnect()
+{
+    const std::string database = conn ? std::string(conn->getSchema().c_str()) : std::string{};
+    PooledConnection fresh = connPool.checkout(endpoint);
+    if (!database.empty())
+        fresh->setSchema(database);
+    setConnection(std::move(fresh), endpoint);
+}
+
+DbExecutor::DbExecutor()
+{
+    worker = std::thread(&DbExecutor::workerLoop, this);
+    canceller = std::thread(&DbExecutor::cancelLoop, this);
+}
+
+DbExecutor::~DbExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(cancelMutex);
+        cancelStopping = true;
+    }
+    cancelCv.notify_all();
+    if (canceller.joinable())
+        canceller.join();
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCv.notify_all();
+
+    if (worker.joinable())
+        worker.join();
+
+    // Połączenie zamykamy dopiero po zatrzymaniu wątku, który był jego właścicielem
+    session.resetConnection();
+}
+
+void DbExecutor::enqueue(std::function<void(DbSession&)> task)
+{
+    ++pending;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        tasks.push_back(std::move(task));
+    }
+    queueCv.notify_one();
+}
+
+void DbExecutor::postCompletion(std::function<void()> callback)
+{
+    std::lock_guard<std::mutex> lock(completedMutex);
+    completed.push_back(std::move(callback));
+    if (completionNotifier)
+        completionNotifier();
+}
+
+CancelTokenPtr DbExecutor::createCancelToken()
+{
+    return CancelTokenPtr(new CancelToken(this));
+}
+
+void DbExecutor::beginCancellable(const CancelTokenPtr& token, const DbSession& workerSession)
+{
+    std::lock_guard<std::mutex> lock(cancelMutex);
+    runningToken = token.get();
+    runningEndpoint = workerSession.getEndpoint();
+    runningConnectionId = workerSession.getConnectionId();
+    killRequested = false;
+}
+
+void DbExecutor::endCancellable()
+{
+    // Czeka na ewentualny KILL w toku - nie może trafić w zapytanie następnego zadania
+    std::lock_guard<std::mutex> lock(cancelMutex);
+    runningToken = nullptr;
+    runningConnectionId = 0;
+    killRequested = false;
+}
+
+void DbExecutor::requestKill(const CancelToken& token)
+{
+    {
+        std::lock_guard<std::mutex> lock(cancelMutex);
+        if (runningToken != &token || runningConnectionId == 0)
+            return; // zadanie jeszcze w kolejce (zostanie pominięte) albo już skończone
+        killRequested = true;
+    }
+    cancelCv.notify_one();
+}
+
+void DbExecutor::cancelLoop()
+{
+    TraceRecorder::setThreadName("DB cancel");
+
+    std::unique_lock<std::mutex> lock(cancelMutex);
+    for (;;)
+    {
+        cancelCv.wait(lock, [this]{ return cancelStopping || killRequested; });
+        if (cancelStopping)
+            return;
+
+        const CancelToken* token = runningToken;
+        const DbEndpoint endpoint = runningEndpoint;
+        const uint64_t connectionId = runningConnectionId;
+        killRequested = false;
+
+        // Połączenie pomocnicze bez blokady - może łączyć się z serwerem. Z puli zarezerwowanej,
+        // więc KILL przechodzi nawet przy wszystkich zwykłych połączeniach zajętych
+        lock.unlock();
+        PooledConnection side;
+        try
+        {
+            side = connectionPool.checkoutReserved(endpoint);
+        }
+        catch (sql::SQLException& e)
+        {
+            std::cerr << "Cannot cancel query: " << e.what() << std::endl;
+        }
+        lock.lock();
+
+        // KILL pod blokadą i tylko gdy wciąż trwa to samo zadanie - endCancellable() na nią czeka
+        if (!side || runningToken != token || runningConnectionId != connectionId)
+            continue;
+        try
+        {
+            TRACE_SCOPE_CAT("KILL QUERY", "db");
+            std::unique_ptr<sql::Statement> stmt(side->createStatement());
+            stmt->execute("KILL QUERY " + std::to_string(connectionId));
+        }
+        catch (sql::SQLException& e)
+        {
+            std::cerr << "Cannot cancel query: " << e.what() << std::endl;
+        }
+    }
+}
+
+void DbExecutor::post(std::function<void()> callback)
+{
+    // pollCompleted zdejmuje po jednym z pending na każdy callback
+    ++pending;
+    postCompletion(std::move(callback));
+}
+
+void DbExecutor::setCompletionNotifier(std::function<void()> notifier)
+{
+    std::lock_guard<std::mutex> lock(completedMutex);
+    completionNotifier = std::move(notifier);
+}
+
+size_t DbExecutor::pollCompleted()
+{
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        ready.swap(completed);
+    }
+
+    for (auto& callback : ready)
+    {
+        callback();
+        --pending;
+    }
+    return ready.size();
+}
+
+void DbExecutor::workerLoop()
+{
+    TraceRecorder::setThreadName("DB worker");
+
+    for (;;)
+    {
+        std::function<void(DbSession&)> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCv.wait(lock, [this]{ return stopping || !tasks.empty(); });
+            if (stopping)
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        try
+        {
+            TRACE_SCOPE_CAT("db task", "db");
+            task(session);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Unhandled error in DB worker: " << e.what() << std::endl;
+        }
+    }
+}
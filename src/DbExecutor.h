@@ -0,0 +1,267 @@
+#pragma once
+
+#include "ConnectionPool.h"
+#include "SchemaCache.h"
+#include "StatementCache.h"
+#include <mariadb/conncpp.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Wynik zadania bazy danych przekazywany do callbacku w wątku UI
+template <typename T>
+struct DbResult
+{
+    T value{};
+    std::string error;
+    bool cancelled = false; // zlecenie anulowane tokenem - error też jest ustawiony
+
+    bool ok() const { return error.empty(); }
+};
+
+class DbExecutor;
+
+// Token anulowania zleceń dla DbExecutor. cancel() (wątek UI): zadania jeszcze w kolejce są pomijane,
+// a zapytanie trwające na serwerze przerywa KILL QUERY wysłany z połączenia pomocniczego z puli.
+// Jeden token może obejmować wiele zleceń (np. wszystkie strony jednego widoku). Nie może przeżyć wykonawcy.
+class CancelToken
+{
+public:
+    void cancel();
+    bool isCancelled() const { return cancelled.load(); }
+
+private:
+    friend class DbExecutor;
+    explicit CancelToken(DbExecutor* owner) : executor(owner) {}
+
+    DbExecutor* executor;
+    std::atomic<bool> cancelled{false};
+};
+using CancelTokenPtr = std::shared_ptr<CancelToken>;
+
+// Stan należący wyłącznie do wątku roboczego - tylko on dotyka sql::Connection
+class DbSession
+{
+public:
+    explicit DbSession(ConnectionPool& connectionPool) : connPool(connectionPool) {}
+
+    bool isConnected() const { return static_cast<bool>(conn); }
+
+    sql::Connection& connection()
+    {
+        if (!conn)
+            throw std::runtime_error("Not connected to database");
+        return *conn;
+    }
+
+    // Połączenie główne jest wypożyczone z puli i wraca do niej przy zmianie/rozłączeniu.
+    // Adres i identyfikator wątku serwera pozwalają przerwać zapytanie z innego połączenia (KILL QUERY).
+    void setConnection(PooledConnection newConn, const DbEndpoint& newEndpoint)
+    {
+        statementCache.clear(); // uchwyty należą do starego połączenia
+        conn = std::move(newConn);
+        endpoint = newEndpoint;
+        std::unique_ptr<sql::Statement> stmt(conn->createStatement());
+        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT CONNECTION_ID()"));
+        connectionId = res->next() ? res->getUInt64(1) : 0;
+        schemaCache.invalidate();
+    }
+
+    void resetConnection()
+    {
+        statementCache.clear();
+        conn = PooledConnection();
+        connectionId = 0;
+        schemaCache.invalidate();
+    }
+
+    const DbEndpoint& getEndpoint() const { return endpoint; }
+    uint64_t getConnectionId() const { return connectionId; }
+
+    // KILL QUERY dla zapytania bieżącego połączenia, z połączenia pomocniczego. Połączenie nie wróci
+    // już do puli - po zamknięciu wyniku trzeba wywołać reconnect(). false, gdy KILL się nie udał
+    bool killQuery();
+    // Zastępuje połączenie nowym z puli, z tą samą bazą
+    void reconnect();
+
+    // Metadane schematu bieżącego połączenia - wspólne dla wszystkich zadań
+    SchemaCache& schema() { return schemaCache; }
+
+    // Przygotowane zapytanie z cache bieżącego połączenia
+    std::shared_ptr<sql::PreparedStatement> prepare(const std::string& sql)
+    {
+        return statementCache.prepare(connection(), sql);
+    }
+
+    const StatementCache& statements() const { return statementCache; }
+
+    // Połączenia pomocnicze (administracyjne, metadane) - zamiast łączyć się od nowa przy każdym kliknięciu
+    ConnectionPool& pool() { return connPool; }
+
+private:
+    ConnectionPool& connPool;
+    PooledConnection conn;
+    DbEndpoint endpoint;
+    uint64_t connectionId = 0;
+    SchemaCache schemaCache;
+    StatementCache statementCache;
+};
+
+// Wątek wykonujący wszystkie zapytania do bazy. UI zleca pracę przez submit(),
+// a wyniki odbiera w callbackach uruchamianych z pollCompleted() w wątku UI.
+class DbExecutor
+{
+public:
+    DbExecutor();
+    ~DbExecutor();
+
+    DbExecutor(const DbExecutor&) = delete;
+    DbExecutor& operator=(const DbExecutor&) = delete;
+
+    // work(DbSession&) -> R wykonuje się w wątku bazy, onDone(DbResult<R>&) w wątku UI.
+    // Z tokenem zlecenie można anulować; onDone jest wołany zawsze, wtedy z DbResult::cancelled.
+    template <typename Work, typename OnDone>
+    void submit(Work&& work, OnDone&& onDone, CancelTokenPtr token = nullptr)
+    {
+        using R = std::invoke_result_t<Work&, DbSession&>;
+        static_assert(!std::is_void_v<R>, "DB work must return a value");
+
+        enqueue([this, work = std::forward<Work>(work), onDone = std::forward<OnDone>(onDone), token](DbSession& workerSession) mutable
+        {
+            auto result = std::make_shared<DbResult<R>>();
+            if (token && token->isCancelled())
+            {
+                result->cancelled = true;
+                result->error = "Query cancelled";
+            }
+            else
+            {
+                beginCancellable(token, workerSession);
+                try
+                {
+                    result->value = work(workerSession);
+                }
+                catch (sql::SQLException& e)
+                {
+                    result->error = e.what();
+                }
+                catch (const std::exception& e)
+                {
+                    result->error = e.what();
+                }
+                endCancellable();
+
+                // Przerwane przez KILL QUERY - błąd serwera zamieniamy na anulowanie
+                if (token && token->isCancelled())
+                {
+                    result->cancelled = true;
+                    if (result->error.empty())
+                        result->error = "Query cancelled";
+                }
+            }
+            postCompletion([onDone = std::move(onDone), result]() mutable { onDone(*result); });
+        });
+    }
+
+    // Wersja z std::future - dla kodu, który może poczekać na wynik (błąd jako wyjątek)
+    template <typename Work>
+    auto submitFuture(Work&& work) -> std::future<std::invoke_result_t<Work&, DbSession&>>
+    {
+        using R = std::invoke_result_t<Work&, DbSession&>;
+        auto promise = std::make_shared<std::promise<R>>();
+        std::future<R> future = promise->get_future();
+
+        enqueue([this, work = std::forward<Work>(work), promise](DbSession& workerSession) mutable
+        {
+            try
+            {
+                if constexpr (std::is_void_v<R>)
+                {
+                    work(workerSession);
+                    promise->set_value();
+                }
+                else
+                {
+                    promise->set_value(work(workerSession));
+                }
+            }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception());
+            }
+            --pending; // brak callbacku w wątku UI
+        });
+        return future;
+    }
+
+    // Token dla zleceń, które UI może chcieć przerwać (zmiana tabeli, zamknięcie popupu)
+    CancelTokenPtr createCancelToken();
+
+    // Z wnętrza zadania: callback do wątku UI jeszcze przed końcem zadania (np. kolejna partia wierszy).
+    // Wykonywany w kolejności zleceń, przed callbackiem zakończenia tego zadania.
+    void post(std::function<void()> callback);
+
+    // Uruchamia callbacki zakończonych zadań - wołane raz na klatkę z wątku UI; zwraca ich liczbę
+    size_t pollCompleted();
+
+    // Wołane z wątku bazy po odłożeniu wyniku - pozwala obudzić pętlę UI czekającą na zdarzenia
+    void setCompletionNotifier(std::function<void()> notifier);
+
+    // Liczba zadań zleconych, a jeszcze nie zakończonych
+    size_t pendingCount() const { return pending.load(); }
+    bool isBusy() const { return pendingCount() > 0; }
+
+    // Pula jest bezpieczna wątkowo - UI czyta z niej tylko statystyki
+    ConnectionPool& pool() { return connectionPool; }
+
+private:
+    friend class CancelToken;
+
+    void enqueue(std::function<void(DbSession&)> task);
+    void postCompletion(std::function<void()> callback);
+    void workerLoop();
+
+    // Wątek bazy: token zadania, które właśnie się wykonuje, i połączenie, na którym działa
+    void beginCancellable(const CancelTokenPtr& token, const DbSession& workerSession);
+    void endCancellable();
+    // Wątek UI: zleca KILL QUERY, jeśli zadanie z tym tokenem właśnie się wykonuje
+    void requestKill(const CancelToken& token);
+    void cancelLoop();
+
+    ConnectionPool connectionPool; // przed sesją - musi przeżyć zwrot jej połączenia
+    DbSession session{connectionPool}; // używane tylko w wątku roboczym
+
+    std::mutex queueMutex;
+    std::condition_variable queueCv;
+    std::deque<std::function<void(DbSession&)>> tasks;
+    bool stopping = false;
+
+    std::mutex completedMutex;
+    std::vector<std::function<void()>> completed;
+    std::function<void()> completionNotifier; // chroniony przez completedMutex
+
+    std::atomic<size_t> pending{0};
+
+    // Przerywanie zapytań - osobny wątek, bo wątek bazy czeka właśnie na przerywane zapytanie
+    std::mutex cancelMutex;
+    std::condition_variable cancelCv;
+    const CancelToken* runningToken = nullptr; // chronione przez cancelMutex
+    DbEndpoint runningEndpoint;
+    uint64_t runningConnectionId = 0;
+    bool killRequested = false;
+    bool cancelStopping = false;
+
+    std::thread worker;
+    std::thread canceller;
+};
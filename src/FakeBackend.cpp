@@ -0,0 +1,224 @@
+#include "FakeBackend.h"
+#include <mariadb/conncpp.hpp>
+#include <algorithm>
+#include <cstdio>
+
+// Wiersze tabeli liczone w locie - pamięć nie rośnie z liczbą wierszy
+class FakeTableRowSource : public RowSource
+{
+public:
+    FakeTableRowSource(const FakeTable& fakeTable, size_t limit) : table(fakeTable), rowCount(std::min(fakeTable.rows, limit))
+    {
+        for (const FakeColumn& fakeColumn : table.columns)
+        {
+            ResultColumn column;
+            column.name = fakeColumn.name;
+            column.type = fakeColumn.type;
+            column.scale = fakeColumn.scale;
+            columns.push_back(std::move(column));
+        }
+    }
+
+    const std::vector<ResultColumn>& getColumns() const override { return columns; }
+
+    bool next() override
+    {
+        if (row >= rowCount)
+            return false;
+        ++row;
+        return true;
+    }
+
+    bool isNull(size_t column) override
+    {
+        const size_t every = table.columns[column].nullEvery;
+        return every > 0 && row % every == 0;
+    }
+
+    // Pierwsza kolumna to klucz 1, 2, 3...; pozostałe wymieszane, żeby sortowanie miało co robić
+    int64_t getInt64(size_t column) override { return static_cast<int64_t>(integer(column)); }
+    uint64_t getUInt64(size_t column) override { return integer(column); }
+    double getDouble(size_t column) override { return static_cast<double>(row) / 3.0 + static_cast<double>(column); }
+
+    std::string_view getText(size_t column) override
+    {
+        const FakeColumn& fakeColumn = table.columns[column];
+        const size_t r = row;
+        char buffer[64];
+        switch (fakeColumn.type)
+        {
+        case ColumnType::Decimal:
+        {
+            // DECIMAL przechowywany natywnie ma co najwyżej 18 cyfr
+            const int scale = std::clamp(fakeColumn.scale, 0, 18);
+            unsigned long long fractionRange = 1;
+            for (int i = 0; i < scale; ++i)
+                fractionRange *= 10;
+            if (scale > 0)
+                std::snprintf(buffer, sizeof(buffer), "%llu.%0*llu", static_cast<unsigned long long>(r % 100000), scale,
+                              static_cast<unsigned long long>(r % fractionRange));
+            else
+                std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(r % 100000));
+            text = buffer;
+            break;
+        }
+        case ColumnType::Date:
+            std::snprintf(buffer, sizeof(buffer), "2024-%02zu-%02zu", r % 12 + 1, r % 28 + 1);
+            text = buffer;
+            break;
+        case ColumnType::DateTime:
+            std::snprintf(buffer, sizeof(buffer), "2024-%02zu-%02zu %02zu:%02zu:%02zu", r % 12 + 1, r % 28 + 1, r % 24, r % 60, (r * 7) % 60);
+            text = buffer;
+            break;
+        case ColumnType::Time:
+            std::snprintf(buffer, sizeof(buffer), "%02zu:%02zu:%02zu", r % 24, r % 60, (r * 7) % 60);
+            text = buffer;
+            break;
+        default:
+            text = fakeColumn.name + "-" + std::to_string(r);
+            break;
+        }
+        return text;
+    }
+
+private:
+    uint64_t integer(size_t column) const
+    {
+        return column == 0 ? row : (row * 2654435761u + column) % 100000;
+    }
+
+    const FakeTable& table;
+    size_t rowCount;
+    size_t row = 0; // numer bieżącego wiersza od 1
+    std::vector<ResultColumn> columns;
+    std::string text;
+};
+
+// Odpowiedź na zapytanie o listę tabel - te same kolumny co w getTablesFromDatabase
+class FakeTableListRowSource : public RowSource
+{
+public:
+    explicit FakeTableListRowSource(const std::map<std::string, FakeTable>& fakeTables) : tables(fakeTables)
+    {
+        columns = { { "TABLE_NAME", ColumnType::Text, 0 },
+                    { "TABLE_ROWS", ColumnType::UInt, 0 },
+                    { "DATA_LENGTH", ColumnType::UInt, 0 },
+                    { "INDEX_LENGTH", ColumnType::UInt, 0 } };
+    }
+
+    const std::vector<ResultColumn>& getColumns() const override { return columns; }
+
+    bool next() override
+    {
+        it = started ? std::next(it) : tables.begin();
+        started = true;
+        return it != tables.end();
+    }
+
+    bool isNull(size_t) override { return false; }
+    int64_t getInt64(size_t column) override { return static_cast<int64_t>(getUInt64(column)); }
+    double getDouble(size_t column) override { return static_cast<double>(getUInt64(column)); }
+
+    // Rozmiary szacowane jak w InnoDB: ok. 16 bajtów na komórkę, 8 bajtów indeksu na wiersz
+    uint64_t getUInt64(size_t column) override
+    {
+        const FakeTable& table = it->second;
+        switch (column)
+        {
+        case 1:
+            return table.rows;
+        case 2:
+            return table.rows * table.columns.size() * 16;
+        case 3:
+            return table.rows * 8;
+        default:
+            return 0;
+        }
+    }
+
+    std::string_view getText(size_t) override { return it->first; }
+
+private:
+    const std::map<std::string, FakeTable>& tables;
+    std::map<std::string, FakeTable>::const_iterator it;
+    bool started = false;
+    std::vector<ResultColumn> columns;
+};
+
+class FakeConnection : public DbConnection
+{
+public:
+    explicit FakeConnection(std::map<std::string, FakeTable> fakeTables) : tables(std::move(fakeTables)) {}
+
+    std::unique_ptr<RowSource> query(const std::string& sql) override
+    {
+        if (sql.find("information_schema.TABLES") != std::string::npos)
+            return std::make_unique<FakeTableListRowSource>(tables);
+
+        // Nazwa tabeli po FROM `...` (`` to znak ` w nazwie), LIMIT na końcu
+        const std::string from = "FROM `";
+        const size_t start = sql.find(from);
+        if (start == std::string::npos)
+            throw sql::SQLException(("Fake backend does not support: " + sql).c_str());
+
+        std::string name;
+        size_t pos = start + from.size();
+        for (; pos < sql.size(); ++pos)
+        {
+            if (sql[pos] == '`')
+            {
+                if (pos + 1 < sql.size() && sql[pos + 1] == '`')
+                    ++pos;
+                else
+                    break;
+            }
+            name += sql[pos];
+        }
+
+        const auto table = tables.find(name);
+        if (table == tables.end())
+            throw sql::SQLException(("Table '" + name + "' doesn't exist").c_str());
+
+        size_t limit = table->second.rows;
+        const size_t limitPos = sql.rfind(" LIMIT ");
+        if (limitPos != std::string::npos && limitPos > pos)
+            limit = static_cast<size_t>(std::stoull(sql.substr(limitPos + 7)));
+        return std::make_unique<FakeTableRowSource>(table->second, limit);
+    }
+
+    std::unique_ptr<RowSource> execute(const std::string& sql, const std::vector<std::string>&, size_t) override
+    {
+        return query(sql);
+    }
+
+    // Zapisy nie zmieniają danych - wiersze wynikają z numeru wiersza
+    uint64_t executeUpdate(const std::string&, const std::vector<std::string>&) override { return 0; }
+
+private:
+    std::map<std::string, FakeTable> tables;
+};
+
+void FakeBackend::addTable(FakeTable table)
+{
+    std::string name = table.name;
+    tables[name] = std::move(table);
+}
+
+FakeTable FakeBackend::makeOrdersTable(size_t rows)
+{
+    FakeTable table;
+    table.name = "orders";
+    table.rows = rows;
+    table.columns = { { "id", ColumnType::Int, 0, 0 },
+                      { "customer", ColumnType::Text, 0, 0 },
+                      { "amount", ColumnType::Decimal, 2, 0 },
+                      { "created_at", ColumnType::DateTime, 0, 0 },
+                      { "ratio", ColumnType::Double, 0, 0 },
+                      { "note", ColumnType::Text, 0, 5 } };
+    return table;
+}
+
+std::unique_ptr<DbConnection> FakeBackend::connect(const DbEndpoint&, const std::string&)
+{
+    return std::make_unique<FakeConnection>(tables);
+}
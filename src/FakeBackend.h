@@ -0,0 +1,41 @@
+#pragma once
+
+#include "DbBackend.h"
+#include <map>
+#include <string>
+#include <vector>
+
+// Backend bez serwera: tabele o zadanej liczbie wierszy, których wartości są wyliczane z numeru wiersza.
+// Każde zapytanie daje ten sam wynik, więc benchmark mierzy tylko dekodowanie i UI - bez sieci i szumu serwera.
+// Rozumie tylko to, czego używa ścieżka przeglądania: SELECT z FROM `tabela` i opcjonalnym LIMIT
+// (WHERE i ORDER BY są pomijane) oraz listę tabel z information_schema.TABLES.
+
+struct FakeColumn
+{
+    std::string name;
+    ColumnType type = ColumnType::Text;
+    int scale = 0;
+    size_t nullEvery = 0; // co n-ty wiersz NULL; 0 - nigdy
+};
+
+struct FakeTable
+{
+    std::string name;
+    size_t rows = 0;
+    std::vector<FakeColumn> columns;
+};
+
+class FakeBackend : public DbBackend
+{
+public:
+    void addTable(FakeTable table);
+
+    // Tabela zamówień z kolumnami typowymi dla przeglądarki: klucz, tekst, DECIMAL, data i czas, liczba, tekst z NULL
+    static FakeTable makeOrdersTable(size_t rows);
+
+    // Połączenia widzą tabele z chwili połączenia; endpoint i nazwa bazy są pomijane
+    std::unique_ptr<DbConnection> connect(const DbEndpoint& endpoint, const std::string& database) override;
+
+private:
+    std::map<std::string, FakeTable> tables;
+};
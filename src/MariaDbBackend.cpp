@@ -0,0 +1,132 @@
+#include "MariaDbBackend.h"
+#include "PerfStats.h"
+#include "Trace.h"
+
+// Sposób przechowywania kolumny wyniku na podstawie typu z metadanych (typy JDBC: REAL to FLOAT z MariaDB)
+static ColumnType storageTypeFor(sql::ResultSetMetaData& meta, int column, int& scale)
+{
+    scale = 0;
+    switch (meta.getColumnType(column))
+    {
+    case sql::DataType::TINYINT:
+    case sql::DataType::SMALLINT:
+    case sql::DataType::INTEGER:
+    case sql::DataType::BOOLEAN:
+        return ColumnType::Int;
+    case sql::DataType::BIGINT:
+        return meta.isSigned(column) ? ColumnType::Int : ColumnType::UInt;
+    case sql::DataType::REAL:
+        return ColumnType::Float;
+    case sql::DataType::FLOAT:
+    case sql::DataType::DOUBLE:
+        return ColumnType::Double;
+    case sql::DataType::DECIMAL:
+    case sql::DataType::NUMERIC:
+        // Więcej niż 18 cyfr nie zmieści się w int64 - zostaje tekst
+        if (meta.getPrecision(column) > 18)
+            return ColumnType::Text;
+        scale = meta.getScale(column);
+        return ColumnType::Decimal;
+    case sql::DataType::DATE:
+        return ColumnType::Date;
+    case sql::DataType::TIMESTAMP:
+        scale = meta.getScale(column);
+        return ColumnType::DateTime;
+    case sql::DataType::TIME:
+        scale = meta.getScale(column);
+        return ColumnType::Time;
+    case sql::DataType::BINARY:
+    case sql::DataType::VARBINARY:
+    case sql::DataType::LONGVARBINARY:
+    case sql::DataType::BLOB:
+        return ColumnType::Bytes;
+    default:
+        return ColumnType::Text;
+    }
+}
+
+// Wynik konektora razem z instrukcją, do której należy (instrukcja musi żyć dłużej niż wynik)
+class MariaDbRowSource : public RowSource
+{
+public:
+    MariaDbRowSource(std::unique_ptr<sql::Statement> statement, std::unique_ptr<sql::ResultSet> resultSet)
+        : stmt(std::move(statement)), res(std::move(resultSet))
+    {
+        sql::ResultSetMetaData* meta = res->getMetaData();
+        const int columnCount = meta->getColumnCount();
+        columns.reserve(static_cast<size_t>(columnCount));
+        for (int i = 1; i <= columnCount; ++i)
+        {
+            ResultColumn column;
+            column.name = meta->getColumnName(i).c_str();
+            column.type = storageTypeFor(*meta, i, column.scale);
+            columns.push_back(std::move(column));
+        }
+    }
+
+    const std::vector<ResultColumn>& getColumns() const override { return columns; }
+    bool next() override { return res->next(); }
+
+    bool isNull(size_t column) override { return res->isNull(index(column)); }
+    int64_t getInt64(size_t column) override { return res->getInt64(index(column)); }
+    uint64_t getUInt64(size_t column) override { return res->getUInt64(index(column)); }
+    double getDouble(size_t column) override { return res->getDouble(index(column)); }
+
+    std::string_view getText(size_t column) override
+    {
+        text = res->getString(index(column));
+        return std::string_view(text.c_str(), text.length());
+    }
+
+private:
+    // Konektor numeruje kolumny od 1
+    static int32_t index(size_t column) { return static_cast<int32_t>(column + 1); }
+
+    // Kolejność pól ma znaczenie - wynik niszczony przed instrukcją
+    std::unique_ptr<sql::Statement> stmt;
+    std::unique_ptr<sql::ResultSet> res;
+    std::vector<ResultColumn> columns;
+    sql::SQLString text;
+};
+
+std::unique_ptr<RowSource> MariaDbConnection::query(const std::string& sql)
+{
+    std::unique_ptr<sql::Statement> stmt(conn.createStatement());
+    std::unique_ptr<sql::ResultSet> res(measureStatement([&] { return stmt->executeQuery(sql); }));
+    return std::make_unique<MariaDbRowSource>(std::move(stmt), std::move(res));
+}
+
+std::unique_ptr<RowSource> MariaDbConnection::execute(const std::string& sql, const std::vector<std::string>& params, size_t fetchSize)
+{
+    // Zawsze przez prepareStatement - na połączeniu z useServerPrepStmts wynik przychodzi protokołem binarnym
+    std::unique_ptr<sql::PreparedStatement> pstmt;
+    {
+        TRACE_SCOPE_CAT("sql.prepare", "db");
+        pstmt.reset(conn.prepareStatement(sql));
+    }
+    for (size_t i = 0; i < params.size(); ++i)
+        pstmt->setString(static_cast<int32_t>(i + 1), params[i]);
+    // Z fetch size konektor nie buforuje całego wyniku - next() czyta kolejne wiersze z gniazda
+    if (fetchSize > 0)
+        pstmt->setFetchSize(static_cast<int32_t>(fetchSize));
+
+    std::unique_ptr<sql::ResultSet> res(measureStatement([&] { return pstmt->executeQuery(); }));
+    return std::make_unique<MariaDbRowSource>(std::move(pstmt), std::move(res));
+}
+
+uint64_t MariaDbConnection::executeUpdate(const std::string& sql, const std::vector<std::string>& params)
+{
+    std::unique_ptr<sql::PreparedStatement> pstmt(conn.prepareStatement(sql));
+    for (size_t i = 0; i < params.size(); ++i)
+        pstmt->setString(static_cast<int32_t>(i + 1), params[i]);
+    const int32_t affected = measureStatement([&] { return pstmt->executeUpdate(); });
+    return affected > 0 ? static_cast<uint64_t>(affected) : 0;
+}
+
+std::unique_ptr<DbConnection> MariaDbBackend::connect(const DbEndpoint& endpoint, const std::string& database)
+{
+    std::unique_ptr<sql::Connection> conn = openConnection(endpoint);
+    if (!database.empty())
+        conn->setSchema(database);
+    return std::make_unique<MariaDbConnection>(std::move(conn));
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "DbBackend.h"
+#include <mariadb/conncpp.hpp>
+#include <memory>
+
+// DbConnection na MariaDB Connector/C++. Konstruktor z referencją nie przejmuje połączenia - tak
+// ścieżka pobierania korzysta z połączenia sesji DbExecutor albo z połączenia wypożyczonego z puli.
+class MariaDbConnection : public DbConnection
+{
+public:
+    explicit MariaDbConnection(sql::Connection& connection) : conn(connection) {}
+    explicit MariaDbConnection(std::unique_ptr<sql::Connection> connection) : owned(std::move(connection)), conn(*owned) {}
+
+    std::unique_ptr<RowSource> query(const std::string& sql) override;
+    std::unique_ptr<RowSource> execute(const std::string& sql, const std::vector<std::string>& params, size_t fetchSize = 0) override;
+    uint64_t executeUpdate(const std::string& sql, const std::vector<std::string>& params) override;
+
+    sql::Connection& native() { return conn; }
+
+private:
+    std::unique_ptr<sql::Connection> owned;
+    sql::Connection& conn;
+};
+
+class MariaDbBackend : public DbBackend
+{
+public:
+    std::unique_ptr<DbConnection> connect(const DbEndpoint& endpoint, const std::string& database) override;
+};
@@ -0,0 +1,362 @@
+#include "PagedTable.h"
+#include "TableFetch.h"
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    struct OpenedTable
+    {
+        std::string pkColumn;
+        TableData firstPage;
+    };
+}
+
+PagedTable::PagedTable(size_t rowsPerPage, size_t pagesKeptAroundView)
+    : pageSize(rowsPerPage), residentMargin(pagesKeptAroundView)
+{
+}
+
+void PagedTable::open(DbExecutor& db, const std::string& name, const TableQuery& newQuery)
+{
+    close();
+    mode = Mode::Opening;
+    tableName = name;
+    query = newQuery;
+
+    const uint64_t requestGeneration = generation;
+    const uint64_t version = dataVersion;
+    const size_t limit = pageSize;
+
+    db.submit(
+        [name, q = query, limit](DbSession& session)
+        {
+            OpenedTable opened;
+            // Keyset wymaga jednokolumnowego klucza głównego
+            auto schema = session.schema().getTable(session.connection(), name);
+            if (schema && schema->primaryKey.size() == 1)
+                opened.pkColumn = schema->primaryKey.front();
+            if (!opened.pkColumn.empty())
+                opened.firstPage = getTablePage(session.connection(), name, opened.pkColumn, q, std::nullopt, std::nullopt, limit);
+            return opened;
+        },
+        [this, requestGeneration, version](DbResult<OpenedTable>& result)
+        {
+            if (requestGeneration != generation)
+                return;
+
+            if (!result.ok())
+            {
+                std::cerr << "Error with opening table " << tableName << ": " << result.error << std::endl;
+                lastError = result.error;
+                mode = Mode::Failed;
+                return;
+            }
+
+            pkColumn = result.value.pkColumn;
+            const auto& firstHeaders = result.value.firstPage.getHeaders();
+            auto it = std::find(firstHeaders.begin(), firstHeaders.end(), pkColumn);
+            if (pkColumn.empty() || it == firstHeaders.end())
+            {
+                mode = Mode::Unsupported;
+                return;
+            }
+
+            pkIndex = static_cast<int>(it - firstHeaders.begin());
+            headers = firstHeaders;
+            updateSortIndex();
+            mode = Mode::Keyset;
+
+            pages.emplace_back();
+            applyPage(0, version, std::move(result.value.firstPage));
+        },
+        getRequestToken(db));
+}
+
+const CancelTokenPtr& PagedTable::getRequestToken(DbExecutor& db)
+{
+    if (!requestToken)
+        requestToken = db.createCancelToken();
+    return requestToken;
+}
+
+void PagedTable::cancelRequests()
+{
+    if (requestToken)
+    {
+        requestToken->cancel();
+        requestToken.reset();
+    }
+}
+
+void PagedTable::close()
+{
+    cancelRequests();
+    ++generation;
+    mode = Mode::Idle;
+    tableName.clear();
+    pkColumn.clear();
+    pkIndex = -1;
+    query = TableQuery{};
+    sortIndex = -1;
+    requerying = false;
+    headers.clear();
+    lastError.clear();
+    pages.clear();
+    pageStart.clear();
+    knownRows = 0;
+    endReached = false;
+}
+
+void PagedTable::invalidate()
+{
+    ++dataVersion;
+}
+
+void PagedTable::setQuery(DbExecutor& db, const TableQuery& newQuery)
+{
+    if (newQuery == query)
+        return;
+
+    if (mode == Mode::Opening)
+    {
+        open(db, tableName, newQuery);
+        return;
+    }
+
+    query = newQuery;
+    if (mode != Mode::Keyset)
+        return;
+
+    // Nowy porządek/filtr unieważnia granice wszystkich stron - zaczynamy od pierwszej.
+    // Do czasu odpowiedzi widoczne zostają stare wiersze, a spóźnione strony są odrzucane.
+    cancelRequests();
+    ++generation;
+    requerying = true;
+    for (Page& page : pages)
+        page.requestedVersion = 0;
+
+    const uint64_t requestGeneration = generation;
+    const uint64_t version = dataVersion;
+    const size_t limit = pageSize;
+
+    db.submit(
+        [name = tableName, pk = pkColumn, q = query, limit](DbSession& session)
+        {
+            return getTablePage(session.connection(), name, pk, q, std::nullopt, std::nullopt, limit);
+        },
+        [this, requestGeneration, version](DbResult<TableData>& result)
+        {
+            if (requestGeneration != generation)
+                return;
+
+            requerying = false;
+            pages.clear();
+            updateSortIndex();
+
+            if (!result.ok())
+            {
+                // Widok zostaje w trybie Keyset (pusty), żeby wiersz filtrów pozwalał poprawić zapytanie
+                std::cerr << "Error with querying table " << tableName << ": " << result.error << std::endl;
+                lastError = result.error;
+                endReached = true;
+                rebuildRowOffsets();
+                return;
+            }
+
+            endReached = false;
+            pages.emplace_back();
+            applyPage(0, version, std::move(result.value));
+        },
+        getRequestToken(db));
+}
+
+void PagedTable::update(DbExecutor& db, size_t firstRow, size_t lastRow)
+{
+    if (mode != Mode::Keyset || pages.empty() || requerying)
+        return;
+
+    const size_t firstPage = pageForRow(firstRow);
+    const size_t lastPage  = pageForRow(lastRow > firstRow ? lastRow - 1 : firstRow);
+
+    // Prefetch następnej strony - tworzymy ją, gdy znamy już ostatni klucz poprzedniej
+    const Page& tail = pages.back();
+    if (!endReached && lastPage + 1 >= pages.size() && tail.loadedVersion != 0 && tail.rowCount > 0)
+    {
+        Page next;
+        next.afterKey = tail.lastKey;
+        pages.push_back(std::move(next));
+        rebuildRowOffsets();
+    }
+
+    const size_t wantFirst = firstPage > 0 ? firstPage - 1 : 0;
+    const size_t wantLast  = std::min(lastPage + 1, pages.size() - 1);
+    for (size_t i = wantFirst; i <= wantLast; ++i)
+    {
+        const Page& page = pages[i];
+        const bool needsFetch = !page.resident || page.loadedVersion != dataVersion;
+        if (needsFetch && page.requestedVersion != dataVersion && page.failedVersion != dataVersion)
+            requestPage(db, i);
+    }
+
+    // Zwolnienie stron daleko od widoku - pamięć ograniczona do kilku stron
+    const size_t keepFirst = firstPage > residentMargin ? firstPage - residentMargin : 0;
+    const size_t keepLast  = lastPage + residentMargin;
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        Page& page = pages[i];
+        if (page.resident && (i < keepFirst || i > keepLast))
+        {
+            page.data = TableData{};
+            page.resident = false;
+        }
+    }
+}
+
+void PagedTable::requestPage(DbExecutor& db, size_t pageIndex)
+{
+    Page& page = pages[pageIndex];
+    page.requestedVersion = dataVersion;
+
+    // Strona ograniczona z góry kluczem następnej - bez LIMIT, żeby wstawione wiersze nie wypadły
+    std::optional<PageKey> upToKey;
+    if (pageIndex + 1 < pages.size())
+        upToKey = pages[pageIndex + 1].afterKey;
+
+    const uint64_t requestGeneration = generation;
+    const uint64_t version = dataVersion;
+    const size_t limit = upToKey ? 0 : pageSize;
+
+    db.submit(
+        [name = tableName, pk = pkColumn, q = query, afterKey = page.afterKey, upToKey, limit](DbSession& session)
+        {
+            return getTablePage(session.connection(), name, pk, q, afterKey, upToKey, limit);
+        },
+        [this, requestGeneration, pageIndex, version](DbResult<TableData>& result)
+        {
+            if (requestGeneration != generation || pageIndex >= pages.size())
+                return;
+
+            Page& target = pages[pageIndex];
+            if (target.requestedVersion == version)
+                target.requestedVersion = 0;
+
+            if (!result.ok())
+            {
+                std::cerr << "Error with loading page " << pageIndex << " of table " << tableName << ": " << result.error << std::endl;
+                lastError = result.error;
+                // Bez ponawiania co klatkę (np. filtr bez indeksu przekraczający max_statement_time)
+                if (!result.cancelled)
+                    target.failedVersion = version;
+                return;
+            }
+
+            applyPage(pageIndex, version, std::move(result.value));
+        },
+        getRequestToken(db));
+}
+
+void PagedTable::applyPage(size_t pageIndex, uint64_t version, TableData&& data)
+{
+    Page& page = pages[pageIndex];
+    if (version < page.loadedVersion)
+        return;
+
+    page.rowCount = data.getRowCount();
+    if (page.rowCount > 0)
+    {
+        const size_t last = page.rowCount - 1;
+        page.lastKey.pk = data.getCellString(last, static_cast<size_t>(pkIndex));
+        page.lastKey.sortValue.reset();
+        if (sortIndex >= 0 && !data.isNull(last, static_cast<size_t>(sortIndex)))
+            page.lastKey.sortValue = data.getCellString(last, static_cast<size_t>(sortIndex));
+    }
+    page.data = std::move(data);
+    page.resident = true;
+    page.loadedVersion = version;
+
+    // Niepełna ostatnia strona (bez górnej granicy) oznacza koniec tabeli
+    if (pageIndex + 1 == pages.size())
+        endReached = page.rowCount < pageSize;
+
+    lastError.clear();
+    rebuildRowOffsets();
+}
+
+void PagedTable::rebuildRowOffsets()
+{
+    pageStart.resize(pages.size());
+    size_t offset = 0;
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        pageStart[i] = offset;
+        offset += pages[i].rowCount;
+    }
+    knownRows = offset;
+}
+
+void PagedTable::updateSortIndex()
+{
+    sortIndex = -1;
+    if (query.sortColumn.empty() || query.sortColumn == pkColumn)
+        return;
+
+    auto it = std::find(headers.begin(), headers.end(), query.sortColumn);
+    if (it != headers.end())
+        sortIndex = static_cast<int>(it - headers.begin());
+}
+
+size_t PagedTable::pageForRow(size_t rowIndex) const
+{
+    if (pages.empty())
+        return 0;
+    if (rowIndex >= knownRows)
+        return pages.size() - 1;
+
+    auto it = std::upper_bound(pageStart.begin(), pageStart.end(), rowIndex);
+    return static_cast<size_t>(it - pageStart.begin()) - 1;
+}
+
+size_t PagedTable::getRowCount() const
+{
+    if (mode != Mode::Keyset)
+        return 0;
+    return knownRows + (endReached ? 0 : 1);
+}
+
+bool PagedTable::isLoading() const
+{
+    if (mode == Mode::Opening || requerying)
+        return true;
+
+    return std::any_of(pages.begin(), pages.end(), [](const Page& page) { return page.requestedVersion != 0; });
+}
+
+RowRef PagedTable::getRow(size_t rowIndex) const
+{
+    if (rowIndex >= knownRows)
+        return {};
+
+    const size_t pageIndex = pageForRow(rowIndex);
+    const Page& page = pages[pageIndex];
+    if (!page.resident)
+        return {};
+
+    const size_t local = rowIndex - pageStart[pageIndex];
+    if (local >= page.data.getRowCount())
+        return {};
+    return RowRef{ &page.data, local };
+}
+
+size_t PagedTable::getResidentPageCount() const
+{
+    return static_cast<size_t>(std::count_if(pages.begin(), pages.end(), [](const Page& page) { return page.resident; }));
+}
+
+size_t PagedTable::getMemoryBytes() const
+{
+    size_t total = 0;
+    for (const Page& page : pages)
+        total += page.data.getMemoryBytes();
+    return total;
+}
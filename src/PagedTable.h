@@ -0,0 +1,106 @@
+#pragma once
+
+#include "TableData.h"
+#include "DbExecutor.h"
+#include "TableQuery.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Stronicowany widok tabeli (keyset pagination po kluczu głównym, opcjonalnie po (kolumna sortowania, pk)).
+// Strona i obejmuje wiersze w przedziale (afterKey_i, afterKey_{i+1}], więc ponowne
+// pobranie pojedynczej strony po zmianach w danych nie gubi ani nie dubluje wierszy.
+// Sortowanie i filtry z TableQuery są wykonywane przez serwer.
+// W pamięci trzymane są tylko strony widoczne i ich sąsiedzi.
+class PagedTable
+{
+public:
+    enum class Mode
+    {
+        Idle,       // nic nie otwarto
+        Opening,    // trwa odczyt PK i pierwszej strony
+        Keyset,      // tabela ma klucz główny - widok stronicowany
+        Unsupported, // brak jednokolumnowego klucza głównego - trzeba pobrać całą tabelę
+        Failed       // błąd odczytu pierwszej strony
+    };
+
+    explicit PagedTable(size_t rowsPerPage = 500, size_t pagesKeptAroundView = 2);
+
+    // Otwiera tabelę od nowa (zmiana tabeli lub Refresh)
+    void open(DbExecutor& db, const std::string& tableName, const TableQuery& query = {});
+    // Zmiana sortowania/filtrów - stare strony są widoczne do czasu nadejścia pierwszej strony nowego wyniku
+    void setQuery(DbExecutor& db, const TableQuery& query);
+    const TableQuery& getQuery() const { return query; }
+    // Po zmianie wierszy: ponowne pobranie stron trzymanych w pamięci, granice stron zostają
+    void invalidate();
+    // Zamyka widok - kolejne open() pobierze wszystko od nowa
+    void close();
+
+    // Zgłasza widoczny zakres wierszy [firstRow, lastRow) - dociąga brakujące strony,
+    // sąsiednie strony (prefetch) i zwalnia strony odległe od widoku
+    void update(DbExecutor& db, size_t firstRow, size_t lastRow);
+
+    Mode getMode() const { return mode; }
+    const std::string& getTableName() const { return tableName; }
+    const std::string& getPrimaryKey() const { return pkColumn; }
+    const std::vector<std::string>& getHeaders() const { return headers; }
+    const std::string& getError() const { return lastError; }
+
+    // Liczba wierszy w znanych stronach; +1 wiersz-zaślepka, dopóki nie doszliśmy do końca tabeli
+    size_t getRowCount() const;
+    bool isEndReached() const { return endReached; }
+    bool isLoading() const;
+
+    // Pusta referencja, gdy strona z wierszem nie jest (jeszcze) w pamięci
+    RowRef getRow(size_t rowIndex) const;
+
+    size_t getResidentPageCount() const;
+    // Pamięć TableData stron trzymanych w pamięci
+    size_t getMemoryBytes() const;
+
+private:
+    struct Page
+    {
+        std::optional<PageKey> afterKey; // dolna granica (wyłączna); brak dla pierwszej strony
+        PageKey lastKey;                 // klucz ostatniego wiersza z ostatniego odczytu
+        size_t rowCount = 0;
+        TableData data;
+        bool resident = false;
+        uint64_t loadedVersion = 0;    // wersja danych, z której pochodzi `data`
+        uint64_t requestedVersion = 0; // wersja, dla której trwa pobieranie (0 - brak)
+        uint64_t failedVersion = 0;    // wersja, której pobranie skończyło się błędem - ponowienie dopiero po invalidate()
+    };
+
+    // Token zleceń bieżącej generacji - anulowany przy open()/close()/setQuery(), więc długie zapytania
+    // poprzedniej tabeli lub filtra są przerywane na serwerze, a nie tylko ignorowane
+    const CancelTokenPtr& getRequestToken(DbExecutor& db);
+    void cancelRequests();
+    void requestPage(DbExecutor& db, size_t pageIndex);
+    void applyPage(size_t pageIndex, uint64_t version, TableData&& data);
+    void rebuildRowOffsets();
+    void updateSortIndex();
+    size_t pageForRow(size_t rowIndex) const;
+
+    size_t pageSize;
+    size_t residentMargin;
+
+    Mode mode = Mode::Idle;
+    std::string tableName;
+    std::string pkColumn;
+    int pkIndex = -1;
+    TableQuery query;
+    int sortIndex = -1;      // kolumna sortowania w nagłówkach; -1 przy sortowaniu po pk
+    bool requerying = false; // trwa pobieranie pierwszej strony po zmianie zapytania
+    std::vector<std::string> headers;
+    std::string lastError;
+
+    std::vector<Page> pages;
+    std::vector<size_t> pageStart; // indeks pierwszego wiersza każdej strony
+    size_t knownRows = 0;
+    bool endReached = false;
+
+    uint64_t generation = 0;  // podbijane przy open()/close(), odrzuca spóźnione odpowiedzi
+    CancelTokenPtr requestToken;
+    uint64_t dataVersion = 1; // podbijane przez invalidate()
+};
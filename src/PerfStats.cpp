@@ -0,0 +1,75 @@
+#include "PerfStats.h"
+#include <algorithm>
+
+PerfStats& PerfStats::instance()
+{
+    static PerfStats stats;
+    return stats;
+}
+
+void PerfStats::recordStatement(double milliseconds)
+{
+    statements.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    if (latencies.size() < LATENCY_WINDOW)
+    {
+        latencies.push_back(milliseconds);
+        return;
+    }
+    latencies[latencyNext] = milliseconds;
+    latencyNext = (latencyNext + 1) % LATENCY_WINDOW;
+}
+
+void PerfStats::recordFetch(uint64_t rows, uint64_t bytes)
+{
+    rowsFetched.fetch_add(rows, std::memory_order_relaxed);
+    bytesFetched.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+PerfStats::LatencyPercentiles PerfStats::getLatencyPercentiles() const
+{
+    std::vector<double> sorted;
+    {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        sorted = latencies;
+    }
+
+    LatencyPercentiles result;
+    result.samples = sorted.size();
+    if (sorted.empty())
+        return result;
+
+    std::sort(sorted.begin(), sorted.end());
+    auto at = [&](double quantile)
+    {
+        const size_t index = static_cast<size_t>(quantile * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    };
+    result.p50 = at(0.50);
+    result.p95 = at(0.95);
+    result.p99 = at(0.99);
+    return result;
+}
+
+void PerfStats::recordFrame(const FrameTimes& times)
+{
+    constexpr double alpha = 0.1;
+    const bool first = averageFrame.renderGui == 0.0 && averageFrame.imguiRender == 0.0 && averageFrame.renderDrawData == 0.0;
+
+    lastFrame = times;
+    if (first)
+    {
+        averageFrame = times;
+    }
+    else
+    {
+        averageFrame.renderGui += alpha * (times.renderGui - averageFrame.renderGui);
+        averageFrame.imguiRender += alpha * (times.imguiRender - averageFrame.imguiRender);
+        averageFrame.renderDrawData += alpha * (times.renderDrawData - averageFrame.renderDrawData);
+    }
+
+    const uint64_t total = getStatementCount();
+    statementsLastFrame = total - statementsAtLastFrame;
+    statementsAtLastFrame = total;
+}
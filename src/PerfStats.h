@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Liczniki wydajności zbierane z wątku bazy i wątku UI - czytane przez nakładkę Performance.
+// Instrumentacja jest lekka: atomowe liczniki i bufor cykliczny ostatnich czasów wykonania zapytań.
+class PerfStats
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct LatencyPercentiles
+    {
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        size_t samples = 0;
+    };
+
+    // Czasy faz jednej klatki w milisekundach (wątek UI)
+    struct FrameTimes
+    {
+        double renderGui = 0.0;
+        double imguiRender = 0.0;
+        double renderDrawData = 0.0;
+    };
+
+    static PerfStats& instance();
+
+    // Bezpieczne wątkowo
+    void recordStatement(double milliseconds);
+    void recordFetch(uint64_t rows, uint64_t bytes);
+
+    uint64_t getStatementCount() const { return statements.load(std::memory_order_relaxed); }
+    uint64_t getRowsFetched() const { return rowsFetched.load(std::memory_order_relaxed); }
+    uint64_t getBytesFetched() const { return bytesFetched.load(std::memory_order_relaxed); }
+    LatencyPercentiles getLatencyPercentiles() const;
+
+    // Tylko wątek UI
+    void recordFrame(const FrameTimes& times);
+    const FrameTimes& getLastFrame() const { return lastFrame; }
+    const FrameTimes& getAverageFrame() const { return averageFrame; }
+    // Zapytania zakończone między dwiema ostatnimi narysowanymi klatkami
+    uint64_t getStatementsLastFrame() const { return statementsLastFrame; }
+
+private:
+    static constexpr size_t LATENCY_WINDOW = 1024;
+
+    std::atomic<uint64_t> statements{0};
+    std::atomic<uint64_t> rowsFetched{0};
+    std::atomic<uint64_t> bytesFetched{0};
+
+    mutable std::mutex latencyMutex;
+    std::vector<double> latencies; // bufor cykliczny ostatnich LATENCY_WINDOW pomiarów
+    size_t latencyNext = 0;
+
+    FrameTimes lastFrame;
+    FrameTimes averageFrame; // średnia wykładnicza
+    uint64_t statementsAtLastFrame = 0;
+    uint64_t statementsLastFrame = 0;
+};
+
+// Wykonuje f() (wywołanie execute/executeQuery/executeUpdate) i dolicza czas do statystyk, także gdy rzuci wyjątek.
+// W trybie nagrywania dodaje też zakres "sql.execute" do śladu.
+template <typename F>
+auto measureStatement(F&& f) -> decltype(f())
+{
+    TRACE_SCOPE_CAT("sql.execute", "db");
+    struct Recorder
+    {
+        PerfStats::Clock::time_point start = PerfStats::Clock::now();
+        ~Recorder()
+        {
+            PerfStats::instance().recordStatement(
+                std::chrono::duration<double, std::milli>(PerfStats::Clock::now() - start).count());
+        }
+    } recorder;
+
+    return std::forward<F>(f)();
+}
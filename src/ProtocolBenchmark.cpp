@@ -0,0 +1,157 @@
+#include "ProtocolBenchmark.h"
+#include "imgui/imgui.h"
+#include <functional>
+#include <stdexcept>
+
+static constexpr int BENCHMARK_ROUNDS = 3;
+
+void ProtocolBenchmark::open(const std::string& table)
+{
+    if (table != tableName)
+    {
+        runs.clear();
+        error.clear();
+    }
+    tableName = table;
+    openRequested = true;
+}
+
+void ProtocolBenchmark::start(DbExecutor& db, const DbEndpoint& endpoint, const std::string& database, const QueryLimits& limits)
+{
+    running = true;
+    runs.clear();
+    error.clear();
+    const unsigned thisRequest = ++request;
+    token = db.createCancelToken();
+
+    db.submit(
+        [endpoint, database, table = tableName, limits, token = token](DbSession& session)
+        {
+            const std::function<bool()> isCancelled = [token]() { return token->isCancelled(); };
+            std::vector<Run> results;
+            for (int round = 0; round < BENCHMARK_ROUNDS; ++round)
+            {
+                for (bool binary : { false, true })
+                {
+                    if (token->isCancelled())
+                        throw std::runtime_error("Benchmark cancelled");
+
+                    DbEndpoint protocolEndpoint = endpoint;
+                    protocolEndpoint.serverPrepared = binary;
+                    PooledConnection conn = session.pool().checkout(protocolEndpoint);
+                    if (!database.empty())
+                        conn->setSchema(database);
+                    results.push_back(Run{ binary, benchmarkTableFetch(*conn, table, limits, isCancelled) });
+                }
+            }
+            if (token->isCancelled())
+                throw std::runtime_error("Benchmark cancelled");
+            return results;
+        },
+        [this, thisRequest](DbResult<std::vector<Run>>& result)
+        {
+            if (thisRequest != request)
+                return;
+            running = false;
+            token.reset();
+            if (!result.ok())
+                error = result.cancelled ? "Benchmark cancelled" : result.error;
+            else
+                runs = std::move(result.value);
+        },
+        token);
+}
+
+void ProtocolBenchmark::render(DbExecutor& db, const DbEndpoint& endpoint, const std::string& database, const QueryLimits& limits)
+{
+    if (openRequested)
+    {
+        ImGui::OpenPopup(PROTOCOL_BENCHMARK_POPUP_ID);
+        openRequested = false;
+    }
+
+    const ImGuiViewport* vp = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(vp->GetCenter(), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+
+    if (!ImGui::BeginPopupModal(PROTOCOL_BENCHMARK_POPUP_ID, nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove))
+        return;
+
+    ImGui::Text("Full table fetch: %s", tableName.c_str());
+    ImGui::TextDisabled("%d alternating rounds per protocol, best time shown", BENCHMARK_ROUNDS);
+    ImGui::Separator();
+
+    if (!runs.empty())
+    {
+        // Najlepszy przebieg każdego protokołu - najmniej zakłócony przez resztę systemu
+        const FetchBenchmark* best[2] = { nullptr, nullptr };
+        for (const Run& run : runs)
+        {
+            const FetchBenchmark*& slot = best[run.binary ? 1 : 0];
+            const double total = run.result.executeMs + run.result.nextMs + run.result.decodeMs;
+            if (!slot || total < slot->executeMs + slot->nextMs + slot->decodeMs)
+                slot = &run.result;
+        }
+
+        if (best[0] && best[1] && ImGui::BeginTable("ProtocolResults", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit))
+        {
+            ImGui::TableSetupColumn("");
+            ImGui::TableSetupColumn("Text");
+            ImGui::TableSetupColumn("Binary");
+            ImGui::TableHeadersRow();
+
+            auto row = [&](const char* label, auto value, const char* format)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::TextUnformatted(label);
+                for (int i = 0; i < 2; ++i)
+                {
+                    ImGui::TableSetColumnIndex(i + 1);
+                    ImGui::Text(format, value(*best[i]));
+                }
+            };
+            row("Rows", [](const FetchBenchmark& b) { return static_cast<unsigned long long>(b.rows); }, "%llu");
+            row("Bytes sent", [](const FetchBenchmark& b) { return static_cast<double>(b.bytesSent) / (1024.0 * 1024.0); }, "%.2f MB");
+            row("Execute", [](const FetchBenchmark& b) { return b.executeMs; }, "%.1f ms");
+            row("next()", [](const FetchBenchmark& b) { return b.nextMs; }, "%.1f ms");
+            row("Decode", [](const FetchBenchmark& b) { return b.decodeMs; }, "%.1f ms");
+            row("Total", [](const FetchBenchmark& b) { return b.executeMs + b.nextMs + b.decodeMs; }, "%.1f ms");
+            ImGui::EndTable();
+        }
+
+        // Oba protokoły mają te same limity - wystarczy opis jednego
+        if (best[0] && !best[0]->truncation.empty())
+            ImGui::TextDisabled("Result truncated: %s", best[0]->truncation.c_str());
+    }
+
+    if (!error.empty())
+        ImGui::TextColored(ImVec4(1, 0, 0, 1), "Błąd: %s", error.c_str());
+
+    ImGui::Separator();
+
+    if (running)
+    {
+        if (token && token->isCancelled())
+        {
+            ImGui::TextDisabled("Cancelling...");
+        }
+        else
+        {
+            ImGui::TextDisabled("Running...");
+            ImGui::SameLine();
+            if (ImGui::Button("Cancel", ImVec2(120, 0)) && token)
+                token->cancel();
+        }
+    }
+    else
+    {
+        if (ImGui::Button("Run", ImVec2(120, 0)))
+            start(db, endpoint, database, limits);
+
+        ImGui::SameLine();
+        if (ImGui::Button("Close", ImVec2(120, 0)))
+            ImGui::CloseCurrentPopup();
+    }
+
+    ImGui::EndPopup();
+}
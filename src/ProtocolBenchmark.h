@@ -0,0 +1,42 @@
+#pragma once
+
+#include "ConnectionPool.h"
+#include "DbExecutor.h"
+#include "TableFetch.h"
+#include <string>
+#include <vector>
+
+inline constexpr const char* PROTOCOL_BENCHMARK_POPUP_ID = "Protocol Benchmark##ProtocolBenchmarkModal";
+
+// Porównanie A/B protokołu tekstowego (createStatement / emulowane prepare) i binarnego
+// (useServerPrepStmts) na tej samej tabeli: bajty wysłane przez serwer i czasy pobierania.
+// Każdy protokół ma własne połączenie z puli; przebiegi są naprzemienne, żeby rozgrzanie
+// bufora serwera nie faworyzowało żadnej strony. Obowiązują limity przeglądania, a Cancel przerywa
+// czytanie wyniku i pomija pozostałe przebiegi.
+class ProtocolBenchmark
+{
+public:
+    // Otwiera popup dla tabeli w następnej klatce
+    void open(const std::string& tableName);
+
+    // limits - te same co przy przeglądaniu tabel (czas zapytania, wiersze, pamięć)
+    void render(DbExecutor& db, const DbEndpoint& endpoint, const std::string& database, const QueryLimits& limits);
+
+private:
+    void start(DbExecutor& db, const DbEndpoint& endpoint, const std::string& database, const QueryLimits& limits);
+
+    struct Run
+    {
+        bool binary = false;
+        FetchBenchmark result;
+    };
+
+    std::string tableName;
+    bool openRequested = false;
+    bool running = false;
+    unsigned request = 0; // wyniki starszego uruchomienia (np. dla innej tabeli) są ignorowane
+    CancelTokenPtr token; // przerywa trwające uruchomienie
+
+    std::vector<Run> runs;
+    std::string error;
+};
@@ -0,0 +1,658 @@
+#include "ResultRecording.h"
+#include "Trace.h"
+#include <mariadb/conncpp.hpp>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <unordered_map>
+
+// Format pliku (liczby całkowite jako LEB128, double jako 8 bajtów little-endian):
+//   "DBMRES1\n", potem zapytania: długość rekordu, rekord
+//   rekord: SQL, liczba parametrów, parametry, executeMs, fetchMs,
+//           liczba kolumn, dla każdej: nazwa, typ (ColumnType, 1 bajt), scale,
+//           liczba wierszy, wiersze
+//   wiersz: mapa bitowa NULL (bit na kolumnę), potem wartości kolumn nie-NULL:
+//           Int - zigzag, UInt - liczba, Double i Float - double, pozostałe - tekst jak z konektora
+//   tekst:  długość, bajty
+static const char FILE_MAGIC[] = "DBMRES1\n";
+static constexpr size_t FILE_MAGIC_SIZE = sizeof(FILE_MAGIC) - 1;
+
+using Clock = std::chrono::steady_clock;
+
+static void putVarint(std::string& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+static void putDouble(std::string& out, double value)
+{
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; ++i)
+        out += static_cast<char>((bits >> (8 * i)) & 0xFF);
+}
+
+static void putText(std::string& out, std::string_view text)
+{
+    putVarint(out, text.size());
+    out.append(text.data(), text.size());
+}
+
+// Odczyt z kontrolą granic - ok == false po próbie czytania za końcem (uszkodzony plik)
+struct ByteReader
+{
+    const char* pos;
+    const char* end;
+    bool ok = true;
+
+    uint64_t varint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (pos == end)
+                break;
+            const unsigned char byte = static_cast<unsigned char>(*pos++);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    double real()
+    {
+        if (end - pos < 8)
+        {
+            ok = false;
+            return 0.0;
+        }
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i)
+            bits |= static_cast<uint64_t>(static_cast<unsigned char>(pos[i])) << (8 * i);
+        pos += 8;
+        double value = 0.0;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string_view text()
+    {
+        const uint64_t size = varint();
+        if (!ok || static_cast<uint64_t>(end - pos) < size)
+        {
+            ok = false;
+            return {};
+        }
+        std::string_view value(pos, static_cast<size_t>(size));
+        pos += size;
+        return value;
+    }
+
+    // Liczba elementów, z których każdy zajmuje co najmniej minItemBytes - większa niż reszta danych
+    // oznacza uszkodzony plik i nie może trafić do alokacji
+    size_t count(size_t minItemBytes)
+    {
+        const uint64_t value = varint();
+        if (!ok || value > static_cast<uint64_t>(end - pos) / minItemBytes)
+        {
+            ok = false;
+            return 0;
+        }
+        return static_cast<size_t>(value);
+    }
+
+    std::string_view bytes(size_t size)
+    {
+        if (static_cast<size_t>(end - pos) < size)
+        {
+            ok = false;
+            return {};
+        }
+        std::string_view value(pos, size);
+        pos += size;
+        return value;
+    }
+};
+
+static std::string queryKey(const std::string& sql, const std::vector<std::string>& params)
+{
+    std::string key = sql;
+    for (const std::string& param : params)
+    {
+        key += '\0';
+        key += param;
+    }
+    return key;
+}
+
+static double elapsedMs(Clock::duration d)
+{
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+// --- Nagrywanie ---
+
+ResultRecorder& ResultRecorder::instance()
+{
+    static ResultRecorder recorder;
+    return recorder;
+}
+
+void ResultRecorder::start()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    queries.clear();
+    bytes = 0;
+    dropped = 0;
+    recording = true;
+}
+
+size_t ResultRecorder::getQueryCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queries.size();
+}
+
+void ResultRecorder::addQuery(std::string header, std::string rows)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!recording)
+        return;
+    const size_t size = header.size() + rows.size();
+    if (bytes + size > MAX_BYTES)
+    {
+        ++dropped;
+        return;
+    }
+    bytes += size;
+    queries.push_back(EncodedQuery{ std::move(header), std::move(rows) });
+}
+
+size_t ResultRecorder::getRemainingBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return recording && bytes < MAX_BYTES ? MAX_BYTES - bytes : 0;
+}
+
+void ResultRecorder::dropQuery()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (recording)
+        ++dropped;
+}
+
+bool ResultRecorder::stopAndSave(const std::string& path, std::string& error)
+{
+    std::vector<EncodedQuery> saved;
+    size_t droppedQueries = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        recording = false;
+        saved.swap(queries);
+        droppedQueries = dropped;
+        bytes = 0;
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out)
+    {
+        error = "Cannot open " + path;
+        return false;
+    }
+
+    out.write(FILE_MAGIC, FILE_MAGIC_SIZE);
+    std::string length;
+    for (const EncodedQuery& query : saved)
+    {
+        length.clear();
+        putVarint(length, query.header.size() + query.rows.size());
+        out.write(length.data(), static_cast<std::streamsize>(length.size()));
+        out.write(query.header.data(), static_cast<std::streamsize>(query.header.size()));
+        out.write(query.rows.data(), static_cast<std::streamsize>(query.rows.size()));
+    }
+
+    if (!out)
+    {
+        error = "Error writing " + path;
+        return false;
+    }
+    if (droppedQueries > 0)
+        error = std::to_string(droppedQueries) + " queries over the size limit were not recorded";
+    return true;
+}
+
+// Czyta wiersz z opakowanego wyniku do pamięci podręcznej (z niej odpowiadają gettery) i od razu go koduje
+class RecordingRowSource : public RowSource
+{
+public:
+    RecordingRowSource(std::unique_ptr<RowSource> source, ResultRecorder& resultRecorder, std::string sql,
+                       const std::vector<std::string>& sqlParams, double executeTimeMs)
+        : inner(std::move(source)), recorder(resultRecorder), statement(std::move(sql)), params(sqlParams),
+          executeMs(executeTimeMs), cells(inner->getColumns().size()), budget(recorder.getRemainingBytes())
+    {
+    }
+
+    ~RecordingRowSource() override
+    {
+        // Wynik porzucony w trakcie (limit wierszy, anulowanie) - zapisane jest to, co przeczytano
+        try
+        {
+            finish();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    const std::vector<ResultColumn>& getColumns() const override { return inner->getColumns(); }
+
+    bool next() override
+    {
+        const Clock::time_point start = Clock::now();
+        const bool hasRow = inner->next();
+        if (hasRow)
+            readRow();
+        fetchTime += Clock::now() - start;
+        if (!hasRow)
+            finish();
+        return hasRow;
+    }
+
+    bool isNull(size_t column) override { return cells[column].null; }
+    int64_t getInt64(size_t column) override { return cells[column].integer; }
+    uint64_t getUInt64(size_t column) override { return cells[column].unsignedInteger; }
+    double getDouble(size_t column) override { return cells[column].real; }
+    std::string_view getText(size_t column) override { return cells[column].text; }
+
+private:
+    struct Cell
+    {
+        bool null = false;
+        int64_t integer = 0;
+        uint64_t unsignedInteger = 0;
+        double real = 0.0;
+        std::string text;
+    };
+
+    void readRow()
+    {
+        const std::vector<ResultColumn>& columns = inner->getColumns();
+        for (size_t c = 0; c < columns.size(); ++c)
+            readCell(c, columns[c].type);
+        ++rowCount;
+
+        // Wynik ponad limit i tak nie trafi do nagrania - dalej tylko wartości dla getterów
+        if (overBudget)
+            return;
+
+        const size_t nullMapOffset = rows.size();
+        rows.append((columns.size() + 7) / 8, '\0');
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            const Cell& cell = cells[c];
+            if (cell.null)
+            {
+                rows[nullMapOffset + c / 8] = static_cast<char>(rows[nullMapOffset + c / 8] | (1 << (c % 8)));
+                continue;
+            }
+
+            switch (columns[c].type)
+            {
+            case ColumnType::Int:
+                putVarint(rows, (static_cast<uint64_t>(cell.integer) << 1) ^ static_cast<uint64_t>(cell.integer >> 63));
+                break;
+            case ColumnType::UInt:
+                putVarint(rows, cell.unsignedInteger);
+                break;
+            case ColumnType::Double:
+            case ColumnType::Float:
+                putDouble(rows, cell.real);
+                break;
+            default:
+                putText(rows, cell.text);
+                break;
+            }
+        }
+
+        if (rows.size() > budget)
+        {
+            overBudget = true;
+            rows = std::string();
+        }
+    }
+
+    void readCell(size_t c, ColumnType type)
+    {
+        Cell& cell = cells[c];
+        cell.null = inner->isNull(c);
+        if (cell.null)
+            return;
+
+        switch (type)
+        {
+        case ColumnType::Int:
+            cell.integer = inner->getInt64(c);
+            break;
+        case ColumnType::UInt:
+            cell.unsignedInteger = inner->getUInt64(c);
+            break;
+        case ColumnType::Double:
+        case ColumnType::Float:
+            cell.real = inner->getDouble(c);
+            break;
+        default:
+            cell.text = inner->getText(c);
+            break;
+        }
+    }
+
+    void finish()
+    {
+        if (finished)
+            return;
+        finished = true;
+        if (overBudget)
+        {
+            recorder.dropQuery();
+            return;
+        }
+
+        std::string record;
+        putText(record, statement);
+        putVarint(record, params.size());
+        for (const std::string& param : params)
+            putText(record, param);
+        putDouble(record, executeMs);
+        putDouble(record, elapsedMs(fetchTime));
+
+        const std::vector<ResultColumn>& columns = inner->getColumns();
+        putVarint(record, columns.size());
+        for (const ResultColumn& column : columns)
+        {
+            putText(record, column.name);
+            record += static_cast<char>(column.type);
+            putVarint(record, static_cast<uint64_t>(column.scale));
+        }
+        putVarint(record, rowCount);
+        recorder.addQuery(std::move(record), std::move(rows));
+    }
+
+    std::unique_ptr<RowSource> inner;
+    ResultRecorder& recorder;
+    std::string statement;
+    std::vector<std::string> params;
+    double executeMs;
+    std::vector<Cell> cells;
+    std::string rows;
+    uint64_t rowCount = 0;
+    Clock::duration fetchTime{};
+    size_t budget;           // miejsce w nagraniu na początku wyniku
+    bool overBudget = false; // wiersze przestały być kodowane, zapytanie liczone jako pominięte
+    bool finished = false;
+};
+
+std::unique_ptr<RowSource> RecordingConnection::query(const std::string& sql)
+{
+    const Clock::time_point start = Clock::now();
+    std::unique_ptr<RowSource> source = inner.query(sql);
+    return std::make_unique<RecordingRowSource>(std::move(source), recorder, sql, std::vector<std::string>{},
+                                                elapsedMs(Clock::now() - start));
+}
+
+std::unique_ptr<RowSource> RecordingConnection::execute(const std::string& sql, const std::vector<std::string>& params, size_t fetchSize)
+{
+    const Clock::time_point start = Clock::now();
+    std::unique_ptr<RowSource> source = inner.execute(sql, params, fetchSize);
+    return std::make_unique<RecordingRowSource>(std::move(source), recorder, sql, params, elapsedMs(Clock::now() - start));
+}
+
+// Zapisy nie mają wyniku do nagrania - idą prosto do opakowanego połączenia
+uint64_t RecordingConnection::executeUpdate(const std::string& sql, const std::vector<std::string>& params)
+{
+    return inner.executeUpdate(sql, params);
+}
+
+// --- Odtwarzanie ---
+
+struct RecordedQuery
+{
+    double executeMs = 0.0;
+    double fetchMs = 0.0;
+    std::vector<ResultColumn> columns;
+    uint64_t rowCount = 0;
+    std::string_view rows; // wskazuje na bajty pliku w ReplayRecording
+};
+
+struct ReplayRecording
+{
+    std::string file;
+    std::unordered_map<std::string, std::vector<RecordedQuery>> queries; // po queryKey, w kolejności nagrania
+    size_t queryCount = 0;
+};
+
+// Dekoduje wiersze nagrania w miejscu - tekst wskazuje prosto na bajty pliku
+class ReplayRowSource : public RowSource
+{
+public:
+    ReplayRowSource(std::shared_ptr<const ReplayRecording> owner, const RecordedQuery& recordedQuery, bool paced)
+        : keepAlive(std::move(owner)), recorded(recordedQuery), reader{ recordedQuery.rows.data(), recordedQuery.rows.data() + recordedQuery.rows.size() },
+          cells(recordedQuery.columns.size()), realTime(paced), start(Clock::now())
+    {
+    }
+
+    const std::vector<ResultColumn>& getColumns() const override { return recorded.columns; }
+
+    bool next() override
+    {
+        if (row == recorded.rowCount)
+        {
+            waitForRow(row);
+            return false;
+        }
+
+        const std::vector<ResultColumn>& columns = recorded.columns;
+        const std::string_view nullMap = reader.bytes((columns.size() + 7) / 8);
+        for (size_t c = 0; c < columns.size() && reader.ok; ++c)
+        {
+            Cell& cell = cells[c];
+            cell.null = (static_cast<unsigned char>(nullMap[c / 8]) >> (c % 8)) & 1;
+            if (cell.null)
+                continue;
+
+            switch (columns[c].type)
+            {
+            case ColumnType::Int:
+            {
+                const uint64_t zigzag = reader.varint();
+                cell.integer = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+                break;
+            }
+            case ColumnType::UInt:
+                cell.unsignedInteger = reader.varint();
+                break;
+            case ColumnType::Double:
+            case ColumnType::Float:
+                cell.real = reader.real();
+                break;
+            default:
+                cell.text = reader.text();
+                break;
+            }
+        }
+        if (!reader.ok)
+            throw sql::SQLException("Recorded result is corrupted");
+
+        ++row;
+        // Tempo oryginału sprawdzane co 64 wiersze - zegar przy każdym wierszu byłby zauważalny
+        if (row % 64 == 0)
+            waitForRow(row);
+        return true;
+    }
+
+    bool isNull(size_t column) override { return cells[column].null; }
+    int64_t getInt64(size_t column) override { return cells[column].integer; }
+    uint64_t getUInt64(size_t column) override { return cells[column].unsignedInteger; }
+    double getDouble(size_t column) override { return cells[column].real; }
+    std::string_view getText(size_t column) override { return cells[column].text; }
+
+private:
+    struct Cell
+    {
+        bool null = false;
+        int64_t integer = 0;
+        uint64_t unsignedInteger = 0;
+        double real = 0.0;
+        std::string_view text;
+    };
+
+    // Wiersze rozłożone równo w czasie pobierania oryginału
+    void waitForRow(uint64_t rowNumber) const
+    {
+        if (!realTime || recorded.rowCount == 0)
+            return;
+        const double ms = recorded.fetchMs * static_cast<double>(rowNumber) / static_cast<double>(recorded.rowCount);
+        std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(ms)));
+    }
+
+    std::shared_ptr<const ReplayRecording> keepAlive;
+    const RecordedQuery& recorded;
+    ByteReader reader;
+    std::vector<Cell> cells;
+    uint64_t row = 0;
+    bool realTime;
+    Clock::time_point start;
+};
+
+class ReplayConnection : public DbConnection
+{
+public:
+    ReplayConnection(std::shared_ptr<const ReplayRecording> data, bool paced)
+        : recording(std::move(data)), realTime(paced) {}
+
+    std::unique_ptr<RowSource> query(const std::string& sql) override
+    {
+        return execute(sql, {}, 0);
+    }
+
+    std::unique_ptr<RowSource> execute(const std::string& sql, const std::vector<std::string>& params, size_t) override
+    {
+        TRACE_SCOPE_CAT("replay.execute", "db");
+        const std::string key = queryKey(sql, params);
+        const auto found = recording->queries.find(key);
+        if (found == recording->queries.end())
+            throw sql::SQLException(("Query not in recording: " + sql).c_str());
+
+        // Kolejne wykonania tego samego zapytania dostają kolejne nagrane wyniki
+        size_t& next = nextIndex[key];
+        const RecordedQuery& recorded = found->second[next];
+        next = (next + 1) % found->second.size();
+
+        if (realTime)
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(recorded.executeMs));
+        return std::make_unique<ReplayRowSource>(recording, recorded, realTime);
+    }
+
+    // Nagranie jest tylko do odczytu - zapisy niczego nie zmieniają
+    uint64_t executeUpdate(const std::string&, const std::vector<std::string>&) override { return 0; }
+
+private:
+    std::shared_ptr<const ReplayRecording> recording;
+    bool realTime;
+    std::unordered_map<std::string, size_t> nextIndex;
+};
+
+ReplayBackend::ReplayBackend() = default;
+ReplayBackend::~ReplayBackend() = default;
+
+bool ReplayBackend::load(const std::string& path, std::string& error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        error = "Cannot open " + path;
+        return false;
+    }
+
+    auto loaded = std::make_shared<ReplayRecording>();
+    loaded->file.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    const std::string& file = loaded->file;
+    if (file.compare(0, FILE_MAGIC_SIZE, FILE_MAGIC) != 0)
+    {
+        error = path + " is not a result recording";
+        return false;
+    }
+
+    ByteReader reader{ file.data() + FILE_MAGIC_SIZE, file.data() + file.size() };
+    while (reader.ok && reader.pos != reader.end)
+    {
+        const uint64_t size = reader.varint();
+        const std::string_view body = reader.bytes(static_cast<size_t>(size));
+        if (!reader.ok)
+            break;
+
+        ByteReader record{ body.data(), body.data() + body.size() };
+        const std::string sql(record.text());
+        // Parametr: co najmniej bajt długości
+        std::vector<std::string> params(record.count(1));
+        for (std::string& param : params)
+            param = record.text();
+
+        RecordedQuery recorded;
+        recorded.executeMs = record.real();
+        recorded.fetchMs = record.real();
+        // Kolumna: co najmniej bajt długości nazwy, bajt typu i bajt skali
+        recorded.columns.resize(record.count(3));
+        for (ResultColumn& column : recorded.columns)
+        {
+            column.name = record.text();
+            const std::string_view type = record.bytes(1);
+            if (!record.ok || static_cast<unsigned char>(type[0]) > static_cast<unsigned char>(ColumnType::Time))
+            {
+                record.ok = false;
+                break;
+            }
+            column.type = static_cast<ColumnType>(type[0]);
+            column.scale = static_cast<int>(record.varint());
+        }
+        recorded.rowCount = record.varint();
+        recorded.rows = std::string_view(record.pos, static_cast<size_t>(record.end - record.pos));
+        if (!record.ok)
+        {
+            reader.ok = false;
+            break;
+        }
+
+        loaded->queries[queryKey(sql, params)].push_back(std::move(recorded));
+        ++loaded->queryCount;
+    }
+
+    if (!reader.ok)
+    {
+        error = path + " is truncated or corrupted";
+        return false;
+    }
+
+    recording = std::move(loaded);
+    return true;
+}
+
+size_t ReplayBackend::getQueryCount() const
+{
+    return recording ? recording->queryCount : 0;
+}
+
+std::unique_ptr<DbConnection> ReplayBackend::connect(const DbEndpoint&, const std::string&)
+{
+    if (!recording)
+        throw sql::SQLException("No recording loaded");
+    return std::make_unique<ReplayConnection>(recording, realTime);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "DbBackend.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Nagrywanie wyników zapytań do pliku binarnego i ich odtwarzanie jako backend.
+// Nagranie zawiera dla każdego zapytania: SQL z parametrami, kolumny, wartości w postaci typowanej
+// (jak w TableData) oraz czas wykonania i pobierania. Odtworzenie idzie tą samą ścieżką co praca
+// na serwerze (getTableData, getTablesFromDatabase...), więc problem z produkcji da się powtórzyć
+// lokalnie bez kopii bazy klienta.
+
+// Nagrywanie całego procesu - gdy jest włączone, ścieżka pobierania na połączeniu MariaDB
+// zapisuje każdy przeczytany wynik. Wyłączone kosztuje jeden odczyt atomowej flagi na zapytanie.
+class ResultRecorder
+{
+public:
+    static ResultRecorder& instance();
+
+    void start();
+    // Zapisuje nagrane zapytania do pliku i kończy nagrywanie; false przy błędzie zapisu
+    bool stopAndSave(const std::string& path, std::string& error);
+
+    bool isRecording() const { return recording.load(std::memory_order_relaxed); }
+    size_t getQueryCount() const;
+
+    // Zakodowane zapytanie (RecordingConnection): nagłówek (SQL, parametry, kolumny) i wiersze osobno -
+    // w pliku leżą jeden za drugim, więc wierszy nie trzeba kopiować do jednego bufora
+    void addQuery(std::string header, std::string rows);
+    // Ile bajtów nagrania jeszcze się zmieści; większy wynik nie jest dalej kodowany
+    size_t getRemainingBytes() const;
+    // Wynik przekroczył limit w trakcie czytania
+    void dropQuery();
+
+private:
+    static constexpr size_t MAX_BYTES = size_t{ 512 } << 20; // dalsze zapytania są pomijane
+
+    struct EncodedQuery
+    {
+        std::string header;
+        std::string rows;
+    };
+
+    std::atomic<bool> recording{ false };
+
+    mutable std::mutex mutex;
+    std::vector<EncodedQuery> queries;
+    size_t bytes = 0;
+    size_t dropped = 0;
+};
+
+// Przepuszcza zapytania do innego połączenia i nagrywa ich wyniki. Wynik jest zapisywany, gdy
+// zostanie przeczytany do końca albo porzucony (wtedy z wierszami przeczytanymi do tej pory).
+class RecordingConnection : public DbConnection
+{
+public:
+    explicit RecordingConnection(DbConnection& connection, ResultRecorder& resultRecorder = ResultRecorder::instance())
+        : inner(connection), recorder(resultRecorder) {}
+
+    std::unique_ptr<RowSource> query(const std::string& sql) override;
+    std::unique_ptr<RowSource> execute(const std::string& sql, const std::vector<std::string>& params, size_t fetchSize = 0) override;
+    uint64_t executeUpdate(const std::string& sql, const std::vector<std::string>& params) override;
+
+private:
+    DbConnection& inner;
+    ResultRecorder& recorder;
+};
+
+struct ReplayRecording;
+
+// Backend odtwarzający nagranie. Zapytanie jest wyszukiwane po SQL i parametrach; powtórzone
+// zapytanie dostaje kolejne nagrane wyniki po kolei (po ostatnim znów pierwszy).
+// Zapytania spoza nagrania kończą się sql::SQLException.
+class ReplayBackend : public DbBackend
+{
+public:
+    ReplayBackend();
+    ~ReplayBackend() override;
+
+    bool load(const std::string& path, std::string& error);
+    size_t getQueryCount() const;
+
+    // Z czasem rzeczywistym odtworzenie trwa tyle co oryginał: czekanie na wykonanie zapytania
+    // i wiersze oddawane w tempie, w jakim przychodziły z serwera
+    void setRealTime(bool enabled) { realTime = enabled; }
+
+    std::unique_ptr<DbConnection> connect(const DbEndpoint& endpoint, const std::string& database) override;
+
+private:
+    std::shared_ptr<const ReplayRecording> recording;
+    bool realTime = false;
+};
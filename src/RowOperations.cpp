@@ -0,0 +1,335 @@
+#include "RowOperations.h"
+#include "PerfStats.h"
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <stdexcept>
+
+static std::string to_lower(std::string s) 
+{
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){ return std::tolower(c); });
+    return s;
+}
+
+static bool parse_server_function_literal(const std::string& in, std::string& outExpr) 
+{
+    std::string s = to_lower(in);
+    // Usuń spacje z początku/końca
+    auto ltrim = [](std::string& x){ x.erase(x.begin(), std::find_if(x.begin(), x.end(), [](unsigned char c){ return !std::isspace(c);})); };
+    auto rtrim = [](std::string& x){ x.erase(std::find_if(x.rbegin(), x.rend(), [](unsigned char c){ return !std::isspace(c);}).base(), x.end()); };
+    std::string t = s;
+    ltrim(t); rtrim(t);
+
+    auto is_name_or_call = [&](const std::string& name)->bool
+    {
+        return (t == name) || (t == name + "()"); 
+    };
+
+    if (is_name_or_call("current_timestamp")) { outExpr = "CURRENT_TIMESTAMP"; return true; }
+    if (is_name_or_call("now"))               { outExpr = "NOW()"; return true; }
+    if (is_name_or_call("curdate"))           { outExpr = "CURDATE()"; return true; }
+    if (is_name_or_call("curtime"))           { outExpr = "CURTIME()"; return true; }
+
+    return false;
+}
+
+std::shared_ptr<const TableSchema> requireTableSchema(DbSession& session, const std::string& tableName)
+{
+    auto schema = session.schema().getTable(session.connection(), tableName);
+    if (!schema)
+        throw std::runtime_error("Unknown table: " + tableName);
+    return schema;
+}
+
+enum class ValKind { Param, ServerFunc, UseDefault };
+
+struct InsertValue
+{
+    ValKind kind = ValKind::Param;
+    std::string text; // Param: wartość bindowana, ServerFunc: dosłowny tekst funkcji (np. CURRENT_TIMESTAMP)
+};
+
+// Klasyfikacja jednej wartości z formularza: DEFAULT, funkcja serwera albo zwykły parametr
+static InsertValue classifyInsertValue(const ColumnInfo* column, const std::string& v)
+{
+    // Jeśli puste i kolumna ma default, użyj DEFAULT
+    if (v.empty() && column && column->defaultValue)
+        return { ValKind::UseDefault, {} };
+
+    // Jeśli użytkownik wpisał "default" (dowolna wielkość liter) -> DEFAULT
+    if (to_lower(v) == "default")
+        return { ValKind::UseDefault, {} };
+
+    // Rozpoznaj funkcje serwera niezależnie od case
+    std::string expr;
+    if (parse_server_function_literal(v, expr))
+        return { ValKind::ServerFunc, expr };
+
+    // W przeciwnym razie zwykły parametr
+    return { ValKind::Param, v };
+}
+
+// Kolumny wstawiane przez INSERT (bez auto_increment) - wspólne dla wszystkich wierszy
+static std::vector<size_t> insertableColumns(const TableSchema& schema, const std::vector<std::string>& cols)
+{
+    std::vector<size_t> indices;
+    indices.reserve(cols.size());
+    for (size_t i = 0; i < cols.size(); ++i)
+    {
+        const ColumnInfo* column = schema.findColumn(cols[i]);
+        if (!(column && column->autoIncrement))
+            indices.push_back(i);
+    }
+    return indices;
+}
+
+static std::vector<InsertValue> classifyRow(const TableSchema& schema, const std::vector<std::string>& cols,
+                                            const std::vector<size_t>& columnIndices, const std::vector<std::string>& values)
+{
+    std::vector<InsertValue> row;
+    row.reserve(columnIndices.size());
+    for (size_t i : columnIndices)
+        row.push_back(classifyInsertValue(schema.findColumn(cols[i]), i < values.size() ? values[i] : std::string{}));
+    return row;
+}
+
+static std::string buildInsertPrefix(const TableSchema& schema, const std::vector<std::string>& cols,
+                                     const std::vector<size_t>& columnIndices)
+{
+    std::string sql = "INSERT INTO `" + schema.name + "` (";
+    for (size_t i = 0; i < columnIndices.size(); ++i)
+    {
+        sql += "`" + cols[columnIndices[i]] + "`";
+        if (i + 1 < columnIndices.size()) sql += ", ";
+    }
+    sql += ") VALUES ";
+    return sql;
+}
+
+// "(?, DEFAULT, NOW())" dla jednego wiersza
+static std::string buildValuesTuple(const std::vector<InsertValue>& row)
+{
+    std::string tuple = "(";
+    for (size_t i = 0; i < row.size(); ++i)
+    {
+        if (row[i].kind == ValKind::UseDefault)
+            tuple += "DEFAULT";
+        else if (row[i].kind == ValKind::ServerFunc)
+            tuple += row[i].text;
+        else // Param
+            tuple += "?";
+
+        if (i + 1 < row.size()) tuple += ", ";
+    }
+    tuple += ")";
+    return tuple;
+}
+
+// Bindowanie tylko dla parametrów; zwraca indeks następnego placeholdera
+static int32_t bindRow(sql::PreparedStatement& pstmt, const std::vector<InsertValue>& row, int32_t nextParamIndex)
+{
+    for (const InsertValue& value : row)
+    {
+        if (value.kind == ValKind::Param)
+            pstmt.setString(nextParamIndex++, value.text);
+    }
+    return nextParamIndex;
+}
+
+BoundSql buildInsertSql(const TableSchema& schema, const std::vector<std::string>& cols, const std::vector<std::string>& values)
+{
+    const std::vector<size_t> columnIndices = insertableColumns(schema, cols);
+    const std::vector<InsertValue> row = classifyRow(schema, cols, columnIndices, values);
+
+    BoundSql statement;
+    statement.sql = buildInsertPrefix(schema, cols, columnIndices) + buildValuesTuple(row);
+    for (const InsertValue& value : row)
+    {
+        if (value.kind == ValKind::Param)
+            statement.params.push_back(value.text);
+    }
+    return statement;
+}
+
+bool insertRow(DbSession& session, const TableSchema& schema,
+               const std::vector<std::string>& cols, const std::vector<std::string>& values)
+{
+    const BoundSql statement = buildInsertSql(schema, cols, values);
+
+    auto pstmt = session.prepare(statement.sql);
+    for (size_t i = 0; i < statement.params.size(); ++i)
+        pstmt->setString(static_cast<int32_t>(i + 1), statement.params[i]);
+
+    measureStatement([&] { return pstmt->execute(); });
+    return true;
+}
+
+// Limit placeholderów w jednym zapytaniu przygotowanym (16-bitowy licznik w protokole)
+static constexpr size_t MAX_PLACEHOLDERS_PER_STATEMENT = 65535;
+
+size_t queryMaxAllowedPacket(sql::Connection& conn)
+{
+    std::unique_ptr<sql::Statement> stmt(conn.createStatement());
+    std::unique_ptr<sql::ResultSet> res(measureStatement([&] { return stmt->executeQuery("SELECT @@max_allowed_packet"); }));
+    if (res->next())
+        return static_cast<size_t>(res->getUInt64(1));
+    return 1024 * 1024; // minimalna wartość serwera
+}
+
+size_t insertRows(sql::Connection& conn, const TableSchema& schema, const std::vector<std::string>& cols,
+                  const std::vector<std::vector<std::string>>& rows, size_t maxPacket)
+{
+    if (rows.empty())
+        return 0;
+
+    const std::vector<size_t> columnIndices = insertableColumns(schema, cols);
+    const std::string prefix = buildInsertPrefix(schema, cols, columnIndices);
+
+    // Zapas na nagłówek pakietu; wartości liczone w najgorszym przypadku (każdy znak escapowany + cudzysłowy)
+    const size_t packetBudget = maxPacket > 4096 ? maxPacket - 1024 : maxPacket;
+
+    std::vector<std::vector<InsertValue>> classified;
+    classified.reserve(rows.size());
+    for (const auto& values : rows)
+        classified.push_back(classifyRow(schema, cols, columnIndices, values));
+
+    conn.setAutoCommit(false);
+    size_t inserted = 0;
+    try
+    {
+        size_t next = 0;
+        while (next < classified.size())
+        {
+            const size_t first = next;
+            std::string sql = prefix;
+            size_t packetBytes = prefix.size();
+            size_t placeholders = 0;
+
+            while (next < classified.size())
+            {
+                const std::vector<InsertValue>& row = classified[next];
+                const std::string tuple = buildValuesTuple(row);
+
+                size_t rowBytes = tuple.size() + 2;
+                size_t rowParams = 0;
+                for (const InsertValue& value : row)
+                {
+                    if (value.kind == ValKind::Param)
+                    {
+                        rowBytes += value.text.size() * 2 + 2;
+                        ++rowParams;
+                    }
+                }
+
+                // Pierwszy wiersz zawsze trafia do zapytania - zbyt duży wiersz zgłosi serwer
+                if (next > first && (packetBytes + rowBytes > packetBudget || placeholders + rowParams > MAX_PLACEHOLDERS_PER_STATEMENT))
+                    break;
+
+                if (next > first)
+                    sql += ", ";
+                sql += tuple;
+                packetBytes += rowBytes;
+                placeholders += rowParams;
+                ++next;
+            }
+
+            // Duże, jednorazowe teksty zapytań nie trafiają do StatementCache
+            std::unique_ptr<sql::PreparedStatement> pstmt;
+            {
+                TRACE_SCOPE_CAT("sql.prepare", "db");
+                pstmt.reset(conn.prepareStatement(sql));
+            }
+            int32_t paramIndex = 1;
+            for (size_t r = first; r < next; ++r)
+                paramIndex = bindRow(*pstmt, classified[r], paramIndex);
+
+            measureStatement([&] { return pstmt->execute(); });
+            inserted += next - first;
+        }
+
+        conn.commit();
+    }
+    catch (...)
+    {
+        // Wszystko albo nic - częściowo wstawiona partia byłaby trudna do poprawienia z UI
+        conn.rollback();
+        conn.setAutoCommit(true);
+        throw;
+    }
+
+    conn.setAutoCommit(true);
+    return inserted;
+}
+
+bool deleteRow(DbSession& session, const std::string& tableName, const std::string& pkColumn, const std::string& pkValue)
+{
+    const std::string sql = "DELETE FROM `" + tableName + "` WHERE `" + pkColumn + "` = ? LIMIT 1;";
+    auto pstmt = session.prepare(sql);
+    pstmt->setString(1, pkValue);
+    measureStatement([&] { return pstmt->execute(); });
+    return true;
+}
+
+LoadedRow loadRowByPk(DbSession& session, const TableSchema& schema,
+                      const std::string& pkColumn, const std::string& pkValue)
+{
+    LoadedRow row;
+    for (const auto& column : schema.columns)
+    {
+        if (!column.autoIncrement)
+            row.columns.push_back(column.name);
+    }
+    const auto& cols = row.columns;
+
+    std::string sql = "SELECT ";
+    for (size_t i = 0; i < cols.size(); ++i)
+    {
+        sql += "`" + cols[i] + "`";
+        if (i + 1 < cols.size()) sql += ", ";
+    }
+    sql += " FROM `" + schema.name + "` WHERE `" + pkColumn + "` = ? LIMIT 1;";
+
+    auto pstmt = session.prepare(sql);
+    pstmt->setString(1, pkValue);
+    std::unique_ptr<sql::ResultSet> res(measureStatement([&] { return pstmt->executeQuery(); }));
+
+    row.values.resize(cols.size());
+    if (res->next())
+    {
+        row.found = true;
+        for (size_t i = 0; i < cols.size(); ++i)
+        {
+            if (!res->isNull(static_cast<int>(i + 1)))
+                row.values[i] = static_cast<std::string>(res->getString(static_cast<int>(i + 1)));
+        }
+    }
+
+    return row;
+}
+
+std::string buildUpdateSql(const std::string& tableName, const std::vector<std::string>& cols, const std::string& pkColumn)
+{
+    std::string sql = "UPDATE `" + tableName + "` SET ";
+    for (size_t i = 0; i < cols.size(); ++i)
+    {
+        sql += "`" + cols[i] + "` = ?";
+        if (i + 1 < cols.size()) sql += ", ";
+    }
+    sql += " WHERE `" + pkColumn + "` = ? LIMIT 1;";
+    return sql;
+}
+
+bool updateRow(DbSession& session, const std::string& tableName, const std::vector<std::string>& cols,
+               const std::vector<std::string>& values, const std::string& pkColumn, const std::string& pkValue)
+{
+    auto pstmt = session.prepare(buildUpdateSql(tableName, cols, pkColumn));
+
+    int bindIndex = 1;
+    for (size_t i = 0; i < cols.size(); ++i)
+        pstmt->setString(bindIndex++, i < values.size() ? values[i] : std::string{});
+
+    pstmt->setString(bindIndex, pkValue);
+
+    measureStatement([&] { return pstmt->execute(); });
+    return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "DbExecutor.h"
+#include "SchemaCache.h"
+#include <mariadb/conncpp.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Zmiany wierszy tabel bez zależności od UI - formularze z TableOperations, import CSV i narzędzia wsadowe.
+// Funkcje synchroniczne - w wątku bazy (zadanie DbExecutor) albo z własną DbSession / własnym połączeniem.
+
+// Metadane tabeli z SchemaCache sesji; nieznana tabela rzuca std::runtime_error
+std::shared_ptr<const TableSchema> requireTableSchema(DbSession& session, const std::string& tableName);
+
+// Tekst zapytania z wartościami do zbindowania (po kolei, jako tekst) - budowany bez połączenia
+struct BoundSql
+{
+    std::string sql;
+    std::vector<std::string> params;
+};
+
+BoundSql buildInsertSql(const TableSchema& schema, const std::vector<std::string>& cols, const std::vector<std::string>& values);
+// UPDATE ... SET `a` = ?, ... WHERE `pk` = ? - wartości kolumn, a na końcu wartość klucza
+std::string buildUpdateSql(const std::string& tableName, const std::vector<std::string>& cols, const std::string& pkColumn);
+
+// INSERT jednego wiersza. Puste pole kolumny z wartością domyślną i tekst "default" dają DEFAULT,
+// a now / current_timestamp / curdate / curtime - funkcję serwera
+bool insertRow(DbSession& session, const TableSchema& schema,
+               const std::vector<std::string>& cols, const std::vector<std::string>& values);
+
+size_t queryMaxAllowedPacket(sql::Connection& conn);
+// Wielowierszowe INSERT ... VALUES (...),(...) w jednej transakcji, dzielone wg max_allowed_packet i limitu placeholderów.
+// Wartości klasyfikowane jak w insertRow. Zwraca liczbę wstawionych wierszy.
+size_t insertRows(sql::Connection& conn, const TableSchema& schema, const std::vector<std::string>& cols,
+                  const std::vector<std::vector<std::string>>& rows, size_t maxAllowedPacket);
+
+bool deleteRow(DbSession& session, const std::string& tableName, const std::string& pkColumn, const std::string& pkValue);
+
+// Aktualne wartości wiersza do edycji
+struct LoadedRow
+{
+    std::vector<std::string> columns; // kolumny edytowalne (bez auto_increment)
+    std::vector<std::string> values;
+    bool found = false;
+};
+LoadedRow loadRowByPk(DbSession& session, const TableSchema& schema,
+                      const std::string& pkColumn, const std::string& pkValue);
+
+// UPDATE po kluczu głównym
+bool updateRow(DbSession& session, const std::string& tableName, const std::vector<std::string>& cols,
+               const std::vector<std::string>& values, const std::string& pkColumn, const std::string& pkValue);
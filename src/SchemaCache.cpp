@@ -0,0 +1,103 @@
+#include "SchemaCache.h"
+#include "PerfStats.h"
+
+const ColumnInfo* TableSchema::findColumn(const std::string& columnName) const
+{
+    for (const auto& column : columns)
+    {
+        if (column.name == columnName)
+            return &column;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const SchemaSnapshot> SchemaCache::loadLocked(sql::Connection& conn)
+{
+    auto loaded = std::make_shared<SchemaSnapshot>();
+
+    // Jedno zapytanie dla wszystkich tabel schematu
+    std::unique_ptr<sql::Statement> stmt(conn.createStatement());
+    std::unique_ptr<sql::ResultSet> res(measureStatement([&]
+    {
+        return stmt->executeQuery(
+            "SELECT TABLE_NAME, COLUMN_NAME, COLUMN_DEFAULT, EXTRA, COLUMN_KEY, DATA_TYPE, IS_NULLABLE "
+            "FROM INFORMATION_SCHEMA.COLUMNS "
+            "WHERE TABLE_SCHEMA = DATABASE() "
+            "ORDER BY TABLE_NAME, ORDINAL_POSITION;");
+    }));
+
+    while (res->next())
+    {
+        std::string tableName = static_cast<std::string>(res->getString("TABLE_NAME"));
+        TableSchema& table = (*loaded)[tableName];
+        table.name = tableName;
+
+        ColumnInfo column;
+        column.name = static_cast<std::string>(res->getString("COLUMN_NAME"));
+        column.dataType = static_cast<std::string>(res->getString("DATA_TYPE"));
+        if (!res->isNull("COLUMN_DEFAULT"))
+            column.defaultValue = static_cast<std::string>(res->getString("COLUMN_DEFAULT"));
+        column.autoIncrement = static_cast<std::string>(res->getString("EXTRA")).find("auto_increment") != std::string::npos;
+        column.primaryKey = static_cast<std::string>(res->getString("COLUMN_KEY")) == "PRI";
+        column.nullable = static_cast<std::string>(res->getString("IS_NULLABLE")) == "YES";
+
+        if (column.primaryKey)
+            table.primaryKey.push_back(column.name);
+        table.columns.push_back(std::move(column));
+    }
+
+    ++loadCount;
+    snapshot = std::move(loaded);
+    missingTables.clear();
+    return snapshot;
+}
+
+std::shared_ptr<const SchemaSnapshot> SchemaCache::getSnapshot(sql::Connection& conn)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!snapshot)
+        return loadLocked(conn);
+    return snapshot;
+}
+
+std::shared_ptr<const TableSchema> SchemaCache::getTable(sql::Connection& conn, const std::string& tableName)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    bool reloaded = false;
+    if (!snapshot)
+    {
+        loadLocked(conn);
+        reloaded = true;
+    }
+
+    auto it = snapshot->find(tableName);
+    if (it == snapshot->end() && !reloaded && missingTables.count(tableName) == 0)
+    {
+        loadLocked(conn);
+        it = snapshot->find(tableName);
+    }
+
+    if (it == snapshot->end())
+    {
+        // Tabela usunięta poza aplikacją nie może kosztować przeładowania schematu w każdej klatce
+        missingTables.insert(tableName);
+        return nullptr;
+    }
+
+    // Wskaźnik do tabeli utrzymuje przy życiu cały snapshot
+    return std::shared_ptr<const TableSchema>(snapshot, &it->second);
+}
+
+void SchemaCache::invalidate()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    snapshot.reset();
+    missingTables.clear();
+}
+
+uint64_t SchemaCache::getLoadCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return loadCount;
+}
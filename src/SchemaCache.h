@@ -0,0 +1,58 @@
+#pragma once
+
+#include <mariadb/conncpp.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Metadane jednej kolumny z INFORMATION_SCHEMA.COLUMNS
+struct ColumnInfo
+{
+    std::string name;
+    std::string dataType;                    // DATA_TYPE, np. "int", "varchar"
+    std::optional<std::string> defaultValue; // COLUMN_DEFAULT (brak = NULL)
+    bool autoIncrement = false;
+    bool primaryKey = false;
+    bool nullable = true;
+};
+
+struct TableSchema
+{
+    std::string name;
+    std::vector<ColumnInfo> columns;     // w kolejności ORDINAL_POSITION
+    std::vector<std::string> primaryKey; // kolumny klucza głównego
+
+    const ColumnInfo* findColumn(const std::string& columnName) const;
+    // Pierwsza kolumna klucza głównego ("" gdy tabela nie ma PK)
+    std::string getPrimaryKeyColumn() const { return primaryKey.empty() ? std::string{} : primaryKey.front(); }
+};
+
+using SchemaSnapshot = std::unordered_map<std::string, TableSchema>;
+
+// Metadane całego schematu wczytywane jednym zapytaniem i współdzielone przez wszystkie
+// operacje na tabelach. Bezpieczne wątkowo; unieważniane po DDL lub jawnym odświeżeniu.
+class SchemaCache
+{
+public:
+    // Zwraca metadane tabeli; przy pierwszym użyciu (lub po unieważnieniu) wczytuje cały schemat.
+    // Nieznana tabela wymusza jednorazowe przeładowanie (mogła powstać poza aplikacją); nazwa, której
+    // nie ma także po przeładowaniu, jest zapamiętywana i kolejne pytania o nią nie czytają schematu do invalidate().
+    std::shared_ptr<const TableSchema> getTable(sql::Connection& conn, const std::string& tableName);
+    std::shared_ptr<const SchemaSnapshot> getSnapshot(sql::Connection& conn);
+
+    void invalidate();
+    uint64_t getLoadCount() const;
+
+private:
+    std::shared_ptr<const SchemaSnapshot> loadLocked(sql::Connection& conn);
+
+    mutable std::mutex mutex;
+    std::shared_ptr<const SchemaSnapshot> snapshot;
+    std::unordered_set<std::string> missingTables; // nazwy nieobecne w bieżącym snapshocie mimo przeładowania
+    uint64_t loadCount = 0;
+};
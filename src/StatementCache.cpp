@@ -0,0 +1,117 @@
+#include "StatementCache.h"
+#include "Trace.h"
+#include <cctype>
+
+StatementCache::StatementCache(size_t maxStatements) : capacity(maxStatements > 0 ? maxStatements : 1)
+{
+}
+
+std::string StatementCache::normalize(const std::string& sql)
+{
+    std::string out;
+    out.reserve(sql.size());
+
+    char quote = 0;          // ', " lub ` gdy jesteśmy wewnątrz literału/identyfikatora
+    bool pendingSpace = false;
+    for (size_t i = 0; i < sql.size(); ++i)
+    {
+        const char c = sql[i];
+        if (quote)
+        {
+            out += c;
+            if (c == '\\' && quote != '`' && i + 1 < sql.size())
+                out += sql[++i];
+            else if (c == quote)
+                quote = 0;
+            continue;
+        }
+
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            pendingSpace = !out.empty();
+            continue;
+        }
+
+        if (pendingSpace)
+        {
+            out += ' ';
+            pendingSpace = false;
+        }
+
+        // Komentarze bez zmian. Jednowierszowy (-- lub #) razem z kończącym go znakiem nowej linii -
+        // inaczej tekst za nim zlałby się z komentarzem i dwa różne zapytania dostałyby ten sam klucz
+        const bool dashComment = c == '-' && i + 1 < sql.size() && sql[i + 1] == '-' &&
+                                 (i + 2 == sql.size() || std::isspace(static_cast<unsigned char>(sql[i + 2])));
+        if (dashComment || c == '#')
+        {
+            const size_t end = sql.find('\n', i);
+            const size_t stop = end == std::string::npos ? sql.size() : end + 1;
+            out.append(sql, i, stop - i);
+            i = stop - 1;
+            continue;
+        }
+        if (c == '/' && i + 1 < sql.size() && sql[i + 1] == '*')
+        {
+            const size_t end = sql.find("*/", i + 2);
+            const size_t stop = end == std::string::npos ? sql.size() : end + 2;
+            out.append(sql, i, stop - i);
+            i = stop - 1;
+            continue;
+        }
+
+        if (c == '\'' || c == '"' || c == '`')
+            quote = c;
+        out += c;
+    }
+
+    while (!out.empty() && (out.back() == ';' || out.back() == ' '))
+        out.pop_back();
+
+    return out;
+}
+
+std::shared_ptr<sql::PreparedStatement> StatementCache::prepare(sql::Connection& conn, const std::string& sql)
+{
+    // Znormalizowany tekst tylko jako klucz - serwer dostaje SQL w oryginalnej postaci
+    std::string key = normalize(sql);
+
+    auto it = entries.find(key);
+    if (it != entries.end())
+    {
+        ++stats.hits;
+        lru.splice(lru.begin(), lru, it->second.lruPos);
+        it->second.statement->clearParameters();
+        return it->second.statement;
+    }
+
+    ++stats.misses;
+    std::shared_ptr<sql::PreparedStatement> statement;
+    {
+        TRACE_SCOPE_CAT("sql.prepare", "db");
+        statement.reset(conn.prepareStatement(sql));
+    }
+
+    if (entries.size() >= capacity)
+    {
+        entries.erase(lru.back());
+        lru.pop_back();
+        ++stats.evictions;
+    }
+
+    lru.push_front(key);
+    entries.emplace(std::move(key), Entry{ statement, lru.begin() });
+    return statement;
+}
+
+void StatementCache::clear()
+{
+    entries.clear();
+    lru.clear();
+}
+
+StatementCacheStats StatementCache::getStats() const
+{
+    StatementCacheStats snapshot = stats;
+    snapshot.size = entries.size();
+    return snapshot;
+}
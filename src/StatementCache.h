@@ -0,0 +1,56 @@
+#pragma once
+
+#include <mariadb/conncpp.hpp>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+struct StatementCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t size = 0;
+
+    double getHitRate() const
+    {
+        const uint64_t total = hits + misses;
+        return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+    }
+};
+
+// LRU przygotowanych zapytań jednego połączenia, kluczowany znormalizowanym tekstem SQL.
+// Uchwyt po stronie serwera (bez ponownego COM_STMT_PREPARE) jest używany ponownie tylko z
+// useServerPrepStmts (DbEndpoint::serverPrepared); w domyślnym trybie tekstowym trafienie oszczędza
+// jedynie parsowanie zapytania po stronie klienta.
+// Należy do DbSession i musi być czyszczony przed zmianą połączenia - uchwyty są powiązane z połączeniem.
+class StatementCache
+{
+public:
+    explicit StatementCache(size_t capacity = 64);
+
+    // Zwraca zapytanie z wyczyszczonymi parametrami; wskaźnik pozostaje ważny także po usunięciu z cache
+    std::shared_ptr<sql::PreparedStatement> prepare(sql::Connection& conn, const std::string& sql);
+
+    void clear();
+    StatementCacheStats getStats() const;
+
+    // Klucz cache: zwija białe znaki poza literałami, identyfikatorami i komentarzami, obcina końcowe średniki
+    static std::string normalize(const std::string& sql);
+
+private:
+    using LruList = std::list<std::string>; // najświeższe na początku
+
+    struct Entry
+    {
+        std::shared_ptr<sql::PreparedStatement> statement;
+        LruList::iterator lruPos;
+    };
+
+    size_t capacity;
+    LruList lru;
+    std::unordered_map<std::string, Entry> entries;
+    StatementCacheStats stats;
+};
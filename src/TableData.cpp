@@ -0,0 +1,647 @@
+#include "TableData.h"
+#include <charconv>
+#include <cstdio>
+
+// Spakowane daty jak w MariaDB (my_datetime_packed): porównanie liczb daje porządek chronologiczny.
+// Data: ((rok * 13 + miesiąc) << 5) | dzień, czas: (godz << 12) | (min << 6) | sek, na końcu 24 bity mikrosekund.
+static constexpr int MAX_DECIMAL_DIGITS = 18;
+static constexpr int MAX_FRACTION_DIGITS = 6;
+
+static constexpr int64_t POW10[] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL,
+    10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL, 100000000000000LL,
+    1000000000000000LL, 10000000000000000LL, 100000000000000000LL, 1000000000000000000LL
+};
+
+// Czyta dokładnie count cyfr
+static bool readDigits(std::string_view text, size_t& pos, size_t count, int64_t& out)
+{
+    if (pos + count > text.size())
+        return false;
+    out = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const char c = text[pos + i];
+        if (c < '0' || c > '9')
+            return false;
+        out = out * 10 + (c - '0');
+    }
+    pos += count;
+    return true;
+}
+
+// Część ułamkowa sekund ".ffffff" (opcjonalna) w mikrosekundach; digits - ile cyfr było w tekście
+static bool readFraction(std::string_view text, size_t& pos, int64_t& micros, int& digits)
+{
+    micros = 0;
+    digits = 0;
+    if (pos == text.size() || text[pos] != '.')
+        return true;
+    ++pos;
+    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+    {
+        if (digits == MAX_FRACTION_DIGITS)
+            return false;
+        micros = micros * 10 + (text[pos] - '0');
+        ++digits;
+        ++pos;
+    }
+    if (digits == 0)
+        return false;
+    micros *= POW10[MAX_FRACTION_DIGITS - digits];
+    return true;
+}
+
+static bool parseDatePart(std::string_view text, size_t& pos, int64_t& packedDate)
+{
+    int64_t year, month, day;
+    if (!readDigits(text, pos, 4, year) || pos == text.size() || text[pos++] != '-' ||
+        !readDigits(text, pos, 2, month) || pos == text.size() || text[pos++] != '-' ||
+        !readDigits(text, pos, 2, day))
+        return false;
+    if (month > 12 || day > 31)
+        return false;
+    packedDate = ((year * 13 + month) << 5) | day;
+    return true;
+}
+
+static bool parseDate(std::string_view text, int64_t& packed)
+{
+    size_t pos = 0;
+    return parseDatePart(text, pos, packed) && pos == text.size();
+}
+
+static bool parseDateTime(std::string_view text, int64_t& packed, int& fractionDigits)
+{
+    size_t pos = 0;
+    int64_t date, hour, minute, second, micros;
+    if (!parseDatePart(text, pos, date) || pos == text.size() || text[pos++] != ' ' ||
+        !readDigits(text, pos, 2, hour) || pos == text.size() || text[pos++] != ':' ||
+        !readDigits(text, pos, 2, minute) || pos == text.size() || text[pos++] != ':' ||
+        !readDigits(text, pos, 2, second) || !readFraction(text, pos, micros, fractionDigits) || pos != text.size())
+        return false;
+    if (hour > 23 || minute > 59 || second > 59)
+        return false;
+    packed = (((date << 17) | (hour << 12) | (minute << 6) | second) << 24) | micros;
+    return true;
+}
+
+static bool parseTime(std::string_view text, int64_t& packed, int& fractionDigits)
+{
+    size_t pos = 0;
+    const bool negative = !text.empty() && text[0] == '-';
+    if (negative)
+        ++pos;
+
+    // Godziny TIME mają od 2 do 3 cyfr (do 838)
+    size_t hourDigits = 0;
+    while (pos + hourDigits < text.size() && text[pos + hourDigits] != ':')
+        ++hourDigits;
+    int64_t hour, minute, second, micros;
+    if (hourDigits < 1 || hourDigits > 3 || !readDigits(text, pos, hourDigits, hour) || pos == text.size() || text[pos++] != ':' ||
+        !readDigits(text, pos, 2, minute) || pos == text.size() || text[pos++] != ':' ||
+        !readDigits(text, pos, 2, second) || !readFraction(text, pos, micros, fractionDigits) || pos != text.size())
+        return false;
+    if (minute > 59 || second > 59)
+        return false;
+    const int64_t magnitude = (((hour << 12) | (minute << 6) | second) << 24) | micros;
+    packed = negative ? -magnitude : magnitude;
+    return true;
+}
+
+// "-123.45" -> mantysa z dokładnie scale cyframi po przecinku
+static bool parseDecimal(std::string_view text, int scale, int64_t& mantissa)
+{
+    size_t pos = 0;
+    const bool negative = !text.empty() && text[0] == '-';
+    if (negative)
+        ++pos;
+
+    int64_t value = 0;
+    int digits = 0;
+    int fractionDigits = 0;
+    bool inFraction = false;
+    for (; pos < text.size(); ++pos)
+    {
+        const char c = text[pos];
+        if (c == '.' && !inFraction)
+        {
+            inFraction = true;
+            continue;
+        }
+        if (c < '0' || c > '9')
+            return false;
+        if (inFraction && ++fractionDigits > scale)
+            return false;
+        if ((value != 0 || c != '0') && ++digits > MAX_DECIMAL_DIGITS)
+            return false;
+        value = value * 10 + (c - '0');
+    }
+    if (digits + (scale - fractionDigits) > MAX_DECIMAL_DIGITS)
+        return false;
+
+    value *= POW10[scale - fractionDigits];
+    mantissa = negative ? -value : value;
+    return true;
+}
+
+static std::string_view formatFraction(char* out, char* end, int64_t micros, int scale)
+{
+    if (scale <= 0)
+        return {};
+    const int written = std::snprintf(out, static_cast<size_t>(end - out), ".%06lld", static_cast<long long>(micros));
+    return std::string_view(out, static_cast<size_t>(written < scale + 1 ? written : scale + 1));
+}
+
+void TableData::setHeaders(std::vector<std::string> newHeaders)
+{
+    clear();
+    headers = std::move(newHeaders);
+    columns.assign(headers.size(), Column{});
+}
+
+void TableData::setColumnType(size_t column, ColumnType type, int scale)
+{
+    // Typ zmienia tylko pusta tabela - inaczej dotychczasowe wartości straciłyby znaczenie
+    if (column >= columns.size() || rowCount != 0 || nextColumn != 0)
+        return;
+
+    if (type == ColumnType::Decimal && (scale < 0 || scale > MAX_DECIMAL_DIGITS))
+        type = ColumnType::Text;
+    if (scale < 0)
+        scale = 0;
+    if ((type == ColumnType::DateTime || type == ColumnType::Time) && scale > MAX_FRACTION_DIGITS)
+        scale = MAX_FRACTION_DIGITS;
+
+    columns[column].type = type;
+    columns[column].scale = scale;
+}
+
+ColumnType TableData::getColumnType(size_t column) const
+{
+    return column < columns.size() ? columns[column].type : ColumnType::Text;
+}
+
+std::string_view TableData::formatValue(const Column& column, size_t row, CellBuffer& buffer) const
+{
+    char* const out = buffer.data();
+    char* const end = buffer.data() + buffer.size();
+
+    switch (column.type)
+    {
+    case ColumnType::Int:
+        return std::string_view(out, static_cast<size_t>(std::to_chars(out, end, column.values[row]).ptr - out));
+    case ColumnType::UInt:
+        return std::string_view(out, static_cast<size_t>(std::to_chars(out, end, static_cast<uint64_t>(column.values[row])).ptr - out));
+    case ColumnType::Double:
+        return std::string_view(out, static_cast<size_t>(std::to_chars(out, end, column.doubles[row]).ptr - out));
+    case ColumnType::Float:
+        // Najkrótszy zapis jako float - "0.1" zamiast 0.10000000149011612
+        return std::string_view(out, static_cast<size_t>(std::to_chars(out, end, static_cast<float>(column.doubles[row])).ptr - out));
+    case ColumnType::Decimal:
+    {
+        const int64_t mantissa = column.values[row];
+        const uint64_t magnitude = mantissa < 0 ? 0 - static_cast<uint64_t>(mantissa) : static_cast<uint64_t>(mantissa);
+        char digits[24];
+        size_t count = static_cast<size_t>(std::to_chars(digits, digits + sizeof(digits), magnitude).ptr - digits);
+
+        char* p = out;
+        if (mantissa < 0)
+            *p++ = '-';
+        const size_t scale = static_cast<size_t>(column.scale);
+        if (count <= scale)
+        {
+            // 0.00ddd
+            *p++ = '0';
+            *p++ = '.';
+            for (size_t i = count; i < scale; ++i)
+                *p++ = '0';
+            for (size_t i = 0; i < count; ++i)
+                *p++ = digits[i];
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (i == count - scale)
+                    *p++ = '.';
+                *p++ = digits[i];
+            }
+        }
+        return std::string_view(out, static_cast<size_t>(p - out));
+    }
+    case ColumnType::Date:
+    {
+        const int64_t packed = column.values[row];
+        const int written = std::snprintf(out, buffer.size(), "%04lld-%02lld-%02lld",
+                                          static_cast<long long>((packed >> 5) / 13), static_cast<long long>((packed >> 5) % 13),
+                                          static_cast<long long>(packed & 31));
+        return std::string_view(out, static_cast<size_t>(written));
+    }
+    case ColumnType::DateTime:
+    {
+        const int64_t packed = column.values[row];
+        const int64_t seconds = packed >> 24;
+        const int64_t date = seconds >> 17;
+        const int written = std::snprintf(out, buffer.size(), "%04lld-%02lld-%02lld %02lld:%02lld:%02lld",
+                                          static_cast<long long>((date >> 5) / 13), static_cast<long long>((date >> 5) % 13),
+                                          static_cast<long long>(date & 31), static_cast<long long>((seconds >> 12) & 31),
+                                          static_cast<long long>((seconds >> 6) & 63), static_cast<long long>(seconds & 63));
+        const std::string_view fraction = formatFraction(out + written, end, packed & 0xFFFFFF, column.scale);
+        return std::string_view(out, static_cast<size_t>(written) + fraction.size());
+    }
+    case ColumnType::Time:
+    {
+        const int64_t packed = column.values[row];
+        const int64_t magnitude = packed < 0 ? -packed : packed;
+        const int64_t seconds = magnitude >> 24;
+        const int written = std::snprintf(out, buffer.size(), "%s%02lld:%02lld:%02lld", packed < 0 ? "-" : "",
+                                          static_cast<long long>(seconds >> 12), static_cast<long long>((seconds >> 6) & 63),
+                                          static_cast<long long>(seconds & 63));
+        const std::string_view fraction = formatFraction(out + written, end, magnitude & 0xFFFFFF, column.scale);
+        return std::string_view(out, static_cast<size_t>(written) + fraction.size());
+    }
+    case ColumnType::Text:
+    case ColumnType::Bytes:
+        break;
+    }
+    return {};
+}
+
+std::string_view TableData::getCell(size_t row, size_t column, CellBuffer& buffer) const
+{
+    if (row >= rowCount || column >= columns.size() || isNull(row, column))
+        return {};
+
+    const Column& col = columns[column];
+    if (!isTextColumn(col))
+        return formatValue(col, row, buffer);
+
+    const uint64_t begin = col.offsets[row];
+    const uint64_t end = row + 1 < col.offsets.size() ? col.offsets[row + 1] : col.arena.size();
+    return std::string_view(col.arena.data() + begin, static_cast<size_t>(end - begin));
+}
+
+std::string TableData::getCellString(size_t row, size_t column) const
+{
+    CellBuffer buffer;
+    return std::string(getCell(row, column, buffer));
+}
+
+bool TableData::isNull(size_t row, size_t column) const
+{
+    if (row >= rowCount || column >= columns.size())
+        return false;
+
+    const auto& bits = columns[column].nullBits;
+    const size_t word = row / 64;
+    return word < bits.size() && (bits[word] >> (row % 64)) & 1u;
+}
+
+int64_t TableData::getInt64(size_t row, size_t column) const
+{
+    if (row >= rowCount || column >= columns.size())
+        return 0;
+
+    const Column& col = columns[column];
+    if (col.type == ColumnType::Double || col.type == ColumnType::Float)
+        return static_cast<int64_t>(col.doubles[row]);
+    return isTextColumn(col) ? 0 : col.values[row];
+}
+
+double TableData::getDouble(size_t row, size_t column) const
+{
+    if (row >= rowCount || column >= columns.size())
+        return 0.0;
+
+    const Column& col = columns[column];
+    switch (col.type)
+    {
+    case ColumnType::Int:
+        return static_cast<double>(col.values[row]);
+    case ColumnType::UInt:
+        return static_cast<double>(static_cast<uint64_t>(col.values[row]));
+    case ColumnType::Double:
+    case ColumnType::Float:
+        return col.doubles[row];
+    case ColumnType::Decimal:
+        return static_cast<double>(col.values[row]) / static_cast<double>(POW10[col.scale]);
+    default:
+        return 0.0;
+    }
+}
+
+TableData::Column& TableData::beginCell(bool null)
+{
+    Column& column = columns[nextColumn];
+    // Wszystkie kolumny bieżącego wiersza mają indeks rowCount
+    auto& bits = column.nullBits;
+    if (bits.size() <= rowCount / 64)
+        bits.resize(rowCount / 64 + 1, 0);
+    if (null)
+        bits[rowCount / 64] |= uint64_t{1} << (rowCount % 64);
+    return column;
+}
+
+void TableData::endCell()
+{
+    // Wiersz jest widoczny dopiero po dopisaniu wszystkich kolumn
+    if (++nextColumn == headers.size())
+    {
+        nextColumn = 0;
+        ++rowCount;
+    }
+}
+
+void TableData::appendTextCell(Column& column, std::string_view value)
+{
+    column.offsets.push_back(column.arena.size());
+    column.arena.insert(column.arena.end(), value.begin(), value.end());
+}
+
+void TableData::demoteToText(Column& column)
+{
+    // Wartości zapisane do tej pory: wiersze [0, rowCount) - bieżący wiersz jeszcze nie dostał tej kolumny
+    std::vector<char> arena;
+    std::vector<uint64_t> offsets;
+    offsets.reserve(rowCount);
+    CellBuffer buffer;
+    for (size_t row = 0; row < rowCount; ++row)
+    {
+        offsets.push_back(arena.size());
+        const bool null = (column.nullBits[row / 64] >> (row % 64)) & 1u;
+        if (!null)
+        {
+            const std::string_view text = formatValue(column, row, buffer);
+            arena.insert(arena.end(), text.begin(), text.end());
+        }
+    }
+
+    column.type = ColumnType::Text;
+    column.arena = std::move(arena);
+    column.offsets = std::move(offsets);
+    column.values = {};
+    column.doubles = {};
+}
+
+void TableData::appendCell(std::string_view value)
+{
+    if (headers.empty())
+        return;
+
+    Column& column = beginCell(false);
+    int64_t packed = 0;
+    int fractionDigits = 0;
+    bool parsed = false;
+    switch (column.type)
+    {
+    case ColumnType::Text:
+    case ColumnType::Bytes:
+        appendTextCell(column, value);
+        endCell();
+        return;
+    case ColumnType::Int:
+    {
+        const auto result = std::from_chars(value.data(), value.data() + value.size(), packed);
+        parsed = result.ec == std::errc() && result.ptr == value.data() + value.size();
+        break;
+    }
+    case ColumnType::UInt:
+    {
+        uint64_t unsignedValue = 0;
+        const auto result = std::from_chars(value.data(), value.data() + value.size(), unsignedValue);
+        parsed = result.ec == std::errc() && result.ptr == value.data() + value.size();
+        packed = static_cast<int64_t>(unsignedValue);
+        break;
+    }
+    case ColumnType::Double:
+    case ColumnType::Float:
+    {
+        double number = 0.0;
+        const auto result = std::from_chars(value.data(), value.data() + value.size(), number);
+        if (result.ec == std::errc() && result.ptr == value.data() + value.size())
+        {
+            column.doubles.push_back(number);
+            endCell();
+            return;
+        }
+        break;
+    }
+    case ColumnType::Decimal:
+        parsed = parseDecimal(value, column.scale, packed);
+        break;
+    case ColumnType::Date:
+        parsed = parseDate(value, packed);
+        break;
+    case ColumnType::DateTime:
+        parsed = parseDateTime(value, packed, fractionDigits);
+        break;
+    case ColumnType::Time:
+        parsed = parseTime(value, packed, fractionDigits);
+        break;
+    }
+
+    // Metadane mogą nie podawać precyzji ułamka sekund - pierwszy wiersz ją ustala
+    if (parsed && fractionDigits > column.scale)
+    {
+        if (rowCount == 0)
+            column.scale = fractionDigits;
+        else
+            parsed = false;
+    }
+
+    if (parsed)
+        column.values.push_back(packed);
+    else
+    {
+        // Wartość, której nie da się wiernie zapisać natywnie (np. data z zerami, większa precyzja) - kolumna przechodzi na tekst
+        demoteToText(column);
+        appendTextCell(column, value);
+    }
+    endCell();
+}
+
+void TableData::appendInt64(int64_t value)
+{
+    if (headers.empty())
+        return;
+
+    Column& column = columns[nextColumn];
+    if (column.type != ColumnType::Int)
+    {
+        CellBuffer buffer;
+        appendCell(std::string_view(buffer.data(), static_cast<size_t>(std::to_chars(buffer.data(), buffer.data() + buffer.size(), value).ptr - buffer.data())));
+        return;
+    }
+
+    beginCell(false);
+    column.values.push_back(value);
+    endCell();
+}
+
+void TableData::appendUInt64(uint64_t value)
+{
+    if (headers.empty())
+        return;
+
+    Column& column = columns[nextColumn];
+    if (column.type != ColumnType::UInt)
+    {
+        CellBuffer buffer;
+        appendCell(std::string_view(buffer.data(), static_cast<size_t>(std::to_chars(buffer.data(), buffer.data() + buffer.size(), value).ptr - buffer.data())));
+        return;
+    }
+
+    beginCell(false);
+    column.values.push_back(static_cast<int64_t>(value));
+    endCell();
+}
+
+void TableData::appendDouble(double value)
+{
+    if (headers.empty())
+        return;
+
+    Column& column = columns[nextColumn];
+    if (column.type != ColumnType::Double && column.type != ColumnType::Float)
+    {
+        CellBuffer buffer;
+        appendCell(std::string_view(buffer.data(), static_cast<size_t>(std::to_chars(buffer.data(), buffer.data() + buffer.size(), value).ptr - buffer.data())));
+        return;
+    }
+
+    beginCell(false);
+    column.doubles.push_back(value);
+    endCell();
+}
+
+void TableData::appendNull()
+{
+    if (headers.empty())
+        return;
+
+    // Miejsce na wartość zostaje zajęte, żeby indeks wiersza wskazywał tę samą pozycję we wszystkich tablicach
+    Column& column = beginCell(true);
+    if (isTextColumn(column))
+        column.offsets.push_back(column.arena.size());
+    else if (column.type == ColumnType::Double || column.type == ColumnType::Float)
+        column.doubles.push_back(0.0);
+    else
+        column.values.push_back(0);
+    endCell();
+}
+
+TableData TableData::takeRows()
+{
+    TableData rows;
+    rows.headers = headers;
+    rows.columns = std::move(columns);
+    rows.rowCount = rowCount;
+    rows.truncation = std::move(truncation);
+    truncation.clear();
+
+    columns.assign(rows.columns.size(), Column{});
+    for (size_t c = 0; c < columns.size(); ++c)
+    {
+        columns[c].type = rows.columns[c].type;
+        columns[c].scale = rows.columns[c].scale;
+    }
+    rowCount = 0;
+    nextColumn = 0;
+    return rows;
+}
+
+void TableData::appendRows(TableData&& other)
+{
+    if (headers.empty())
+    {
+        *this = std::move(other);
+        return;
+    }
+    if (other.columns.size() != columns.size() || nextColumn != 0 || other.nextColumn != 0)
+        return;
+
+    for (size_t c = 0; c < columns.size(); ++c)
+    {
+        Column& dst = columns[c];
+        Column& src = other.columns[c];
+
+        if (dst.type != src.type && !(isTextColumn(dst) && isTextColumn(src)))
+        {
+            if (!isTextColumn(dst))
+                demoteToText(dst);
+            if (!isTextColumn(src))
+                other.demoteToText(src);
+        }
+        // Precyzja ułamka sekund mogła zostać ustalona osobno w każdej partii
+        if (src.scale > dst.scale)
+            dst.scale = src.scale;
+
+        dst.values.insert(dst.values.end(), src.values.begin(), src.values.end());
+        dst.doubles.insert(dst.doubles.end(), src.doubles.begin(), src.doubles.end());
+
+        const uint64_t arenaBase = dst.arena.size();
+        dst.arena.insert(dst.arena.end(), src.arena.begin(), src.arena.end());
+        dst.offsets.reserve(dst.offsets.size() + src.offsets.size());
+        for (uint64_t offset : src.offsets)
+            dst.offsets.push_back(arenaBase + offset);
+
+        dst.nullBits.resize((rowCount + other.rowCount + 63) / 64, 0);
+        for (size_t word = 0; word < src.nullBits.size(); ++word)
+        {
+            const uint64_t bits = src.nullBits[word];
+            if (bits == 0)
+                continue;
+            for (size_t bit = 0; bit < 64; ++bit)
+            {
+                if (!((bits >> bit) & 1u))
+                    continue;
+                const size_t row = rowCount + word * 64 + bit;
+                dst.nullBits[row / 64] |= uint64_t{1} << (row % 64);
+            }
+        }
+    }
+    rowCount += other.rowCount;
+    if (other.isTruncated())
+        truncation = std::move(other.truncation);
+    other.clear();
+}
+
+void TableData::clear()
+{
+    for (auto& column : columns)
+    {
+        column.values.clear();
+        column.doubles.clear();
+        column.arena.clear();
+        column.offsets.clear();
+        column.nullBits.clear();
+    }
+    rowCount = 0;
+    nextColumn = 0;
+    truncation.clear();
+}
+
+size_t TableData::getMemoryBytes() const
+{
+    size_t bytes = columns.capacity() * sizeof(Column);
+    for (const auto& column : columns)
+    {
+        bytes += column.values.capacity() * sizeof(int64_t);
+        bytes += column.doubles.capacity() * sizeof(double);
+        bytes += column.arena.capacity();
+        bytes += column.offsets.capacity() * sizeof(uint64_t);
+        bytes += column.nullBits.capacity() * sizeof(uint64_t);
+    }
+    for (const auto& header : headers)
+        bytes += sizeof(std::string) + header.capacity();
+    return bytes;
+}
+
+size_t TableData::getPayloadBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& column : columns)
+        bytes += column.arena.size() + column.values.size() * sizeof(int64_t) + column.doubles.size() * sizeof(double);
+    return bytes;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Sposób przechowywania kolumny w TableData - wybierany z typu kolumny w ResultSetMetaData
+enum class ColumnType
+{
+    Text,     // bajty wartości w arenie kolumny
+    Bytes,    // jak Text, ale dane binarne (BINARY, VARBINARY, BLOB)
+    Int,      // int64
+    UInt,     // uint64 (BIGINT UNSIGNED), bity trzymane w int64
+    Double,   // double (DOUBLE, REAL)
+    Float,    // FLOAT - trzymany jako double, formatowany z precyzją float
+    Decimal,  // DECIMAL do 18 cyfr: int64 z przesuniętym przecinkiem o scale cyfr
+    Date,     // spakowane rok/miesiąc/dzień
+    DateTime, // DATETIME i TIMESTAMP - spakowana data, czas i mikrosekundy
+    Time      // TIME ze znakiem - spakowane godziny (do 838), minuty, sekundy i mikrosekundy
+};
+
+// Bufor na sformatowaną wartość liczbową lub datę - wystarcza dla int64, double, DECIMAL(18) i DATETIME(6)
+using CellBuffer = std::array<char, 48>;
+
+// Wynik zapytania w układzie kolumnowym. Liczby, DECIMAL i daty są trzymane natywnie (8 bajtów
+// na komórkę) i formatowane dopiero przy odczycie - w praktyce tylko dla widocznych komórek.
+// Tekst i dane binarne leżą w ciągłej arenie kolumny, z tablicą przesunięć początków komórek;
+// koniec komórki to początek następnej. Każda kolumna ma też bitmapę NULL-i.
+// string_view zwracane przez getCell() są ważne do kolejnego append*/clear() i zmiany bufora.
+class TableData
+{
+public:
+    // Ustawia nagłówki; wszystkie kolumny są tekstowe, dopóki setColumnType() nie powie inaczej
+    void setHeaders(std::vector<std::string> newHeaders);
+    const std::vector<std::string>& getHeaders() const { return headers; }
+    // Przed dopisaniem pierwszego wiersza. scale: cyfry po przecinku (Decimal) lub ułamka sekund (DateTime, Time)
+    void setColumnType(size_t column, ColumnType type, int scale = 0);
+    ColumnType getColumnType(size_t column) const;
+
+    size_t getRowCount() const { return rowCount; }
+    size_t getColumnCount() const { return headers.size(); }
+
+    // Tekst komórki - kolumny tekstowe bez kopiowania, typowane sformatowane do bufora
+    std::string_view getCell(size_t row, size_t column, CellBuffer& buffer) const;
+    std::string getCellString(size_t row, size_t column) const;
+    bool isNull(size_t row, size_t column) const;
+
+    // Wartości natywne do sortowania i agregatów po stronie klienta.
+    // getInt64: Int/UInt, Decimal (bez przecinka), daty (spakowane, zachowują porządek); getDouble: kolumny liczbowe
+    int64_t getInt64(size_t row, size_t column) const;
+    double getDouble(size_t row, size_t column) const;
+
+    // Budowanie wyniku: wartości kolejnych kolumn wiersz po wierszu.
+    // appendCell dla kolumn Decimal i dat parsuje tekst z serwera; jeśli się nie da
+    // (np. wartość spoza zakresu), kolumna bez straty przechodzi na tekst.
+    void appendCell(std::string_view value);
+    void appendInt64(int64_t value);
+    void appendUInt64(uint64_t value);
+    void appendDouble(double value);
+    void appendNull();
+
+    // Strumieniowanie partiami: takeRows oddaje dotychczasowe wiersze, zostawiając puste kolumny tego samego typu;
+    // appendRows dokleja partię o tych samych kolumnach (kolumna tekstowa w jednej z nich zmienia obie na tekst)
+    TableData takeRows();
+    void appendRows(TableData&& other);
+
+    void clear();
+
+    // Wynik obcięty przez limit zapytania - powód do pokazania użytkownikowi ("" - wynik pełny)
+    void setTruncation(std::string reason) { truncation = std::move(reason); }
+    const std::string& getTruncation() const { return truncation; }
+    bool isTruncated() const { return !truncation.empty(); }
+
+    // Przybliżony rozmiar w pamięci (areny + wartości + przesunięcia + bitmapy + nagłówki)
+    size_t getMemoryBytes() const;
+    // Rozmiar samych wartości
+    size_t getPayloadBytes() const;
+
+private:
+    struct Column
+    {
+        ColumnType type = ColumnType::Text;
+        int scale = 0;
+        std::vector<int64_t> values;   // Int, UInt, Decimal, daty
+        std::vector<double> doubles;   // Double, Float
+        std::vector<char> arena;       // Text, Bytes
+        std::vector<uint64_t> offsets; // Text, Bytes: początek komórki w arenie
+        std::vector<uint64_t> nullBits;
+    };
+
+    bool isTextColumn(const Column& column) const { return column.type == ColumnType::Text || column.type == ColumnType::Bytes; }
+    std::string_view formatValue(const Column& column, size_t row, CellBuffer& buffer) const;
+    // Formatuje wszystkie dotychczasowe wartości do areny i zmienia typ kolumny na Text
+    void demoteToText(Column& column);
+    void appendTextCell(Column& column, std::string_view value);
+    Column& beginCell(bool null);
+    void endCell();
+
+    std::vector<std::string> headers;
+    std::vector<Column> columns;
+    size_t rowCount = 0;
+    size_t nextColumn = 0; // kolumna, do której trafi następna wartość
+    std::string truncation;
+};
+
+// Lekka referencja do wiersza wewnątrz TableData
+struct RowRef
+{
+    const TableData* table = nullptr;
+    size_t row = 0;
+
+    explicit operator bool() const { return table != nullptr; }
+    std::string_view getCell(size_t column, CellBuffer& buffer) const { return table->getCell(row, column, buffer); }
+    std::string getCellString(size_t column) const { return table->getCellString(row, column); }
+    bool isNull(size_t column) const { return table->isNull(row, column); }
+};
@@ -0,0 +1,204 @@
+#include "TableDataCache.h"
+#include "TableFetch.h"
+#include <iostream>
+
+const TableData* TableDataCache::get(DbExecutor& db, const std::string& tableName, const TableQuery& query)
+{
+    Entry& entry = entries[tableName];
+    if (entry.query != query)
+    {
+        entry.query = query;
+        ++entry.version;
+    }
+
+    if (entry.loadedVersion != entry.version && entry.requestedVersion != entry.version && entry.failedVersion != entry.version)
+    {
+        // Strumień poprzedniej wersji nie jest już potrzebny
+        cancelLoad(entry);
+
+        const uint64_t version = entry.version;
+        const uint64_t requestEpoch = epoch;
+        const uint64_t loadId = ++entry.loadId;
+        const CancelTokenPtr token = db.createCancelToken();
+        entry.requestedVersion = version;
+        entry.loadToken = token;
+        entry.loadRows = 0;
+        entry.error.clear();
+        entry.loadStart = std::chrono::steady_clock::now();
+
+        DbExecutor* executor = &db;
+        db.submit(
+            [this, executor, tableName, query, version, requestEpoch, loadId, token, rowsPerFetch = fetchSize](DbSession& session)
+            {
+                // Klucz główny przed danymi - przycisk edycji działa już przy pierwszej partii
+                auto schema = session.schema().getTable(session.connection(), tableName);
+                const std::string pkColumn = schema ? schema->getPrimaryKeyColumn() : std::string{};
+
+                size_t rows = 0;
+                streamTableData(session, tableName, query, rowsPerFetch,
+                    [this, executor, tableName, version, requestEpoch, loadId, token, &pkColumn, &rows](TableData&& batch)
+                    {
+                        rows += batch.getRowCount();
+                        // std::function wymaga kopiowalnego callbacku - partia jedzie we współdzielonym wskaźniku
+                        auto shared = std::make_shared<TableData>(std::move(batch));
+                        executor->post([this, tableName, loadId, version, requestEpoch, pkColumn, shared]()
+                        {
+                            applyBatch(tableName, loadId, version, requestEpoch, pkColumn, std::move(*shared));
+                        });
+                        return !token->isCancelled();
+                    });
+                return rows;
+            },
+            [this, tableName, loadId, version, requestEpoch](DbResult<size_t>& result)
+            {
+                if (requestEpoch != epoch)
+                    return;
+
+                auto it = entries.find(tableName);
+                if (it == entries.end() || it->second.loadId != loadId)
+                    return; // anulowane albo zastąpione nowszym pobraniem
+
+                Entry& target = it->second;
+                target.requestedVersion = 0;
+                target.loadToken.reset();
+
+                if (!result.ok())
+                {
+                    if (!result.cancelled)
+                    {
+                        std::cerr << "Error with loading table " << tableName << ": " << result.error << std::endl;
+                        target.error = result.error;
+                        target.failedVersion = version;
+                    }
+                    return;
+                }
+                target.complete = true;
+            },
+            token);
+    }
+
+    return entry.loadedVersion != 0 ? &entry.data : nullptr;
+}
+
+void TableDataCache::applyBatch(const std::string& tableName, uint64_t loadId, uint64_t version, uint64_t requestEpoch,
+                                const std::string& pkColumn, TableData&& batch)
+{
+    if (requestEpoch != epoch)
+        return;
+
+    // Tylko partie bieżącego pobrania - anulowane i zastąpione są odrzucane
+    auto it = entries.find(tableName);
+    if (it == entries.end() || it->second.loadId != loadId)
+        return;
+
+    Entry& target = it->second;
+    target.loadRows += batch.getRowCount();
+
+    if (target.loadedVersion != version)
+    {
+        // Pierwsza partia nowej wersji zastępuje dane
+        target.data = std::move(batch);
+        target.pkColumn = pkColumn;
+        target.loadedVersion = version;
+        target.complete = false;
+    }
+    else
+    {
+        target.data.appendRows(std::move(batch));
+    }
+}
+
+void TableDataCache::cancelLoad(Entry& entry)
+{
+    if (!entry.loadToken)
+        return;
+
+    entry.loadToken->cancel();
+    entry.loadToken.reset();
+    entry.requestedVersion = 0;
+    ++entry.loadId;
+}
+
+void TableDataCache::cancelLoadsExcept(const std::string& tableName)
+{
+    for (auto& [name, entry] : entries)
+    {
+        if (name == tableName || !entry.loadToken)
+            continue;
+
+        cancelLoad(entry);
+        if (!entry.complete)
+        {
+            entry.data = TableData{};
+            entry.loadedVersion = 0;
+        }
+    }
+}
+
+std::string TableDataCache::getPrimaryKey(const std::string& tableName) const
+{
+    auto it = entries.find(tableName);
+    return it != entries.end() ? it->second.pkColumn : std::string{};
+}
+
+bool TableDataCache::isLoading(const std::string& tableName) const
+{
+    auto it = entries.find(tableName);
+    return it != entries.end() && it->second.requestedVersion != 0;
+}
+
+std::string TableDataCache::getError(const std::string& tableName) const
+{
+    auto it = entries.find(tableName);
+    return it != entries.end() ? it->second.error : std::string{};
+}
+
+TableDataCache::LoadProgress TableDataCache::getLoadProgress(const std::string& tableName) const
+{
+    LoadProgress progress;
+    auto it = entries.find(tableName);
+    if (it == entries.end() || it->second.requestedVersion == 0)
+        return progress;
+
+    const Entry& entry = it->second;
+    progress.loading = true;
+    progress.rows = entry.loadRows;
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - entry.loadStart).count();
+    progress.rowsPerSecond = seconds > 0.0 ? static_cast<double>(entry.loadRows) / seconds : 0.0;
+    return progress;
+}
+
+void TableDataCache::invalidate(const std::string& tableName)
+{
+    auto it = entries.find(tableName);
+    if (it != entries.end())
+        ++it->second.version;
+}
+
+void TableDataCache::invalidateAll()
+{
+    for (auto& [name, entry] : entries)
+        ++entry.version;
+}
+
+void TableDataCache::clear()
+{
+    for (auto& [name, entry] : entries)
+        cancelLoad(entry);
+    entries.clear();
+    ++epoch;
+}
+
+uint64_t TableDataCache::getVersion(const std::string& tableName) const
+{
+    auto it = entries.find(tableName);
+    return it != entries.end() ? it->second.version : 0;
+}
+
+size_t TableDataCache::getMemoryBytes() const
+{
+    size_t total = 0;
+    for (const auto& [name, entry] : entries)
+        total += entry.data.getMemoryBytes();
+    return total;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "TableData.h"
+#include "DbExecutor.h"
+#include "TableQuery.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Pamięć podręczna wyników SELECT * kluczowana nazwą tabeli i wersją danych.
+// Zapytanie idzie do bazy (w wątku DbExecutor) tylko wtedy, gdy wersja tabeli
+// została podbita przez invalidate(). Wynik przychodzi strumieniowo: pierwsza partia
+// nowej wersji zastępuje dane, kolejne są doklejane, więc pierwszy ekran jest widoczny od razu.
+class TableDataCache
+{
+public:
+    // Postęp trwającego pobierania
+    struct LoadProgress
+    {
+        bool loading = false;
+        size_t rows = 0;            // wiersze nowej wersji, które już dotarły
+        double rowsPerSecond = 0.0;
+    };
+
+    // Zwraca dane tabeli lub nullptr, jeśli pierwsza partia jeszcze nie dotarła.
+    // Nieaktualne dane są zwracane do czasu nadejścia nowych. Zmiana query (sortowanie/filtry) pobiera dane od nowa.
+    // Wersja, której pobranie się nie udało, nie jest pobierana ponownie do invalidate() albo zmiany query.
+    const TableData* get(DbExecutor& db, const std::string& tableName, const TableQuery& query = {});
+
+    // Kolumna klucza głównego pobrana razem z danymi ("" gdy brak)
+    std::string getPrimaryKey(const std::string& tableName) const;
+    bool isLoading(const std::string& tableName) const;
+    LoadProgress getLoadProgress(const std::string& tableName) const;
+    // Błąd ostatniego pobrania (np. przekroczony max_statement_time, zanim przyszedł pierwszy wiersz); "" gdy brak
+    std::string getError(const std::string& tableName) const;
+
+    // Ile wierszy konektor czyta z serwera naraz w trybie strumieniowym
+    void setFetchSize(size_t rows) { fetchSize = rows > 0 ? rows : 1; }
+    size_t getFetchSize() const { return fetchSize; }
+
+    // Przerywa pobieranie pozostałych tabel (zmiana wybranej tabeli). Niepełne dane są odrzucane,
+    // więc powrót do tabeli pobierze ją od nowa.
+    void cancelLoadsExcept(const std::string& tableName);
+
+    void invalidate(const std::string& tableName);
+    void invalidateAll();
+    void clear();
+
+    uint64_t getVersion(const std::string& tableName) const;
+
+    // Suma pamięci TableData wszystkich wpisów
+    size_t getMemoryBytes() const;
+
+private:
+    struct Entry
+    {
+        TableData data;
+        std::string pkColumn;
+        TableQuery query;              // sortowanie/filtry bieżącej wersji
+        uint64_t version = 1;          // aktualna wersja danych tabeli
+        uint64_t loadedVersion = 0;    // wersja, dla której pobrano `data`
+        uint64_t requestedVersion = 0; // wersja, dla której trwa pobieranie
+        uint64_t failedVersion = 0;    // wersja, której pobranie skończyło się błędem - bez ponawiania co klatkę
+
+        bool complete = false;         // `data` zawiera cały wynik, a nie tylko pierwsze partie
+        uint64_t loadId = 0;           // podbijane przy każdym pobraniu i anulowaniu - spóźnione partie są odrzucane
+        CancelTokenPtr loadToken;      // przerywa trwające pobieranie
+        size_t loadRows = 0;
+        std::string error;
+        std::chrono::steady_clock::time_point loadStart;
+    };
+
+    // Partia wierszy w wątku UI
+    void applyBatch(const std::string& tableName, uint64_t loadId, uint64_t version, uint64_t requestEpoch, const std::string& pkColumn,
+                    TableData&& batch);
+    void cancelLoad(Entry& entry);
+
+    std::unordered_map<std::string, Entry> entries;
+    uint64_t epoch = 0; // podbijane przez clear(), odrzuca wyniki sprzed czyszczenia
+    size_t fetchSize = 1000;
+};
@@ -0,0 +1,566 @@
+#include "TableFetch.h"
+#include "DbExecutor.h"
+#include "MariaDbBackend.h"
+#include "PerfStats.h"
+#include "ResultRecording.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+// Ścieżka DbConnection na połączeniu MariaDB; przy włączonym ResultRecorder wyniki są nagrywane
+template <typename F>
+static auto withMariaDb(sql::Connection& conn, F&& fetch)
+{
+    MariaDbConnection adapter(conn);
+    if (!ResultRecorder::instance().isRecording())
+        return fetch(static_cast<DbConnection&>(adapter));
+    RecordingConnection recording(adapter);
+    return fetch(static_cast<DbConnection&>(recording));
+}
+
+// Pobiera listę tabel z bazy danych razem ze statystykami - jedno zapytanie dla całej bazy zamiast COUNT(*) na tabelę
+std::vector<TableInfo> getTablesFromDatabase(DbConnection& conn) 
+{
+    std::vector<TableInfo> tables{};
+    try 
+    {
+        std::unique_ptr<RowSource> res = conn.query("SELECT TABLE_NAME, TABLE_ROWS, DATA_LENGTH, INDEX_LENGTH FROM information_schema.TABLES "
+                                                    "WHERE TABLE_SCHEMA = DATABASE() ORDER BY TABLE_NAME");
+
+        // Pobiera nazwy tabel i statystyki (widoki mają NULL)
+        while (res->next()) 
+        {
+            TableInfo info;
+            info.name = std::string(res->getText(0));
+            info.hasStats = !res->isNull(1);
+            if (info.hasStats)
+            {
+                info.approxRows = res->getUInt64(1);
+                info.dataBytes = res->isNull(2) ? 0 : res->getUInt64(2);
+                info.indexBytes = res->isNull(3) ? 0 : res->getUInt64(3);
+            }
+            tables.push_back(std::move(info));
+        }
+    } 
+    catch (sql::SQLException& e) 
+    {
+        std::cerr << "Error with getting tables: " << e.what() << std::endl;
+    }
+
+    return tables;
+}
+
+std::vector<TableInfo> getTablesFromDatabase(sql::Connection& conn)
+{
+    return withMariaDb(conn, [](DbConnection& db) { return getTablesFromDatabase(db); });
+}
+
+// Czasy pętli pobierania, gdy ktoś o nie prosi (benchmark protokołów)
+struct FetchTimings
+{
+    double nextMs = 0.0;
+    double decodeMs = 0.0;
+};
+
+// Partie w trybie strumieniowym: pierwsza zaraz po pierwszym ekranie wierszy, kolejne co BATCH_INTERVAL
+// albo po MAX_BATCH_ROWS - UI dostaje dane w miarę nadchodzenia, a narzut przekazywania pozostaje mały
+static constexpr size_t FIRST_BATCH_ROWS = 256;
+static constexpr size_t MAX_BATCH_ROWS = 65536;
+static constexpr std::chrono::milliseconds BATCH_INTERVAL(50);
+
+// Kod błędu MariaDB po przekroczeniu max_statement_time (ER_STATEMENT_TIMEOUT)
+static constexpr int ER_STATEMENT_TIMEOUT = 1969;
+
+// Przepisuje nagłówki i wiersze wyniku zapytania do TableData.
+// Z onBatch wiersze są oddawane partiami (także pusta ostatnia partia z samymi kolumnami, jeśli nic nie przyszło)
+// i w tableData zostają tylko kolumny; onBatch zwraca false, żeby przerwać czytanie.
+// Z limits czytanie kończy się po maxRows wierszach, po przekroczeniu budżetu bajtów albo gdy serwer przerwie
+// zapytanie po max_statement_time - wynik (ostatnia partia) dostaje wtedy opis obcięcia zamiast błędu.
+// Zwraca true, gdy na serwerze mogły zostać nieprzeczytane wiersze (budżet bajtów, onBatch zwrócił false).
+static bool readResultSet(RowSource& res, TableData& tableData, FetchTimings* timings = nullptr,
+                          const RowBatchCallback* onBatch = nullptr, const QueryLimits* limits = nullptr)
+{
+    const std::vector<ResultColumn>& columns = res.getColumns();
+    const size_t columnCount = columns.size();
+
+    // Pobiera nagłówki kolumn 
+    std::vector<std::string> headers;
+    headers.reserve(columnCount);
+    for (const ResultColumn& column : columns)
+        headers.push_back(column.name);
+    tableData.setHeaders(std::move(headers));
+
+    // Liczby czytane bez pośredniego tekstu; DECIMAL i daty parsowane do postaci natywnej w TableData
+    std::vector<ColumnType> types(columnCount);
+    for (size_t i = 0; i < columnCount; ++i)
+    {
+        types[i] = columns[i].type;
+        tableData.setColumnType(i, types[i], columns[i].scale);
+    }
+
+    // Pobiera wiersze danych - wartości trafiają prosto do kolumn, bez std::string na komórkę.
+    // W trybie nagrywania śladu czas next() (odczyt z sieci) i dekodowania komórek jest sumowany
+    // i zapisywany w argumentach zakresu - zakres na każdy wiersz zalałby plik śladu.
+    TraceScope fetchSpan("fetch loop", "db");
+    const bool timed = fetchSpan.isActive() || timings;
+    using Clock = TraceRecorder::Clock;
+    Clock::duration nextTime{};
+    Clock::duration convertTime{};
+
+    size_t totalRows = 0;
+    size_t totalBytes = 0;
+    size_t batchesSent = 0;
+    bool stoppedEarly = false;
+    std::string truncation;
+    std::chrono::steady_clock::time_point lastBatch = std::chrono::steady_clock::now();
+    // Oddaje bieżącą partię; false - odbiorca nie chce więcej
+    auto flushBatch = [&]() -> bool
+    {
+        totalRows += tableData.getRowCount();
+        totalBytes += tableData.getPayloadBytes();
+        ++batchesSent;
+        lastBatch = std::chrono::steady_clock::now();
+        return (*onBatch)(tableData.takeRows());
+    };
+
+    for (;;)
+    {
+        Clock::time_point nextStart;
+        if (timed)
+            nextStart = Clock::now();
+        try
+        {
+            if (!res.next())
+                break;
+        }
+        catch (sql::SQLException& e)
+        {
+            // Przekroczony czas w trakcie przesyłania - zostaje to, co już przyszło
+            if (!limits || e.getErrorCode() != ER_STATEMENT_TIMEOUT)
+                throw;
+            char seconds[32];
+            std::snprintf(seconds, sizeof(seconds), "%g", limits->maxStatementSeconds);
+            truncation = std::string("statement time limit (") + seconds + " s) exceeded";
+            break;
+        }
+
+        if (limits)
+        {
+            // Wiersz ponad limit (zapytanie ma LIMIT maxRows + 1) oznacza, że wynik jest niepełny.
+            // Budżet bajtów sprawdzany co 64 wiersze - tyle wynosi też możliwe przekroczenie
+            const size_t rowsSoFar = totalRows + tableData.getRowCount();
+            if (limits->maxRows > 0 && rowsSoFar >= limits->maxRows)
+            {
+                // Po LIMIT maxRows + 1 ten wiersz był ostatni - nie ma czego przerywać
+                truncation = "row limit (" + std::to_string(limits->maxRows) + " rows) reached";
+                break;
+            }
+            if (limits->maxBytes > 0 && rowsSoFar % 64 == 0 &&
+                totalBytes + tableData.getPayloadBytes() >= limits->maxBytes)
+            {
+                truncation = "memory limit (" + std::to_string(limits->maxBytes >> 20) + " MB) reached";
+                stoppedEarly = true;
+                break;
+            }
+        }
+
+        Clock::time_point convertStart;
+        if (timed)
+        {
+            convertStart = Clock::now();
+            nextTime += convertStart - nextStart;
+        }
+
+        for (size_t i = 0; i < columnCount; ++i) 
+        {
+            if (res.isNull(i))
+            {
+                tableData.appendNull();
+                continue;
+            }
+
+            switch (types[i])
+            {
+            case ColumnType::Int:
+                tableData.appendInt64(res.getInt64(i));
+                break;
+            case ColumnType::UInt:
+                tableData.appendUInt64(res.getUInt64(i));
+                break;
+            case ColumnType::Double:
+            case ColumnType::Float:
+                tableData.appendDouble(res.getDouble(i));
+                break;
+            default:
+                tableData.appendCell(res.getText(i));
+                break;
+            }
+        }
+
+        if (timed)
+            convertTime += Clock::now() - convertStart;
+
+        if (onBatch)
+        {
+            // Zegar tylko co 64 wiersze - sprawdzanie czasu przy każdym wierszu byłoby zauważalne
+            const size_t rows = tableData.getRowCount();
+            const bool due = batchesSent == 0 ? rows >= FIRST_BATCH_ROWS
+                                              : rows >= MAX_BATCH_ROWS ||
+                                                (rows % 64 == 0 && std::chrono::steady_clock::now() - lastBatch >= BATCH_INTERVAL);
+            if (due && !flushBatch())
+            {
+                stoppedEarly = true;
+                break;
+            }
+        }
+    }
+
+    tableData.setTruncation(truncation);
+    if (onBatch && (tableData.getRowCount() > 0 || batchesSent == 0 || !truncation.empty()))
+        flushBatch();
+    totalRows += tableData.getRowCount();
+    totalBytes += tableData.getPayloadBytes();
+
+    auto toMs = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+    if (timings)
+    {
+        timings->nextMs = toMs(nextTime);
+        timings->decodeMs = toMs(convertTime);
+    }
+
+    if (fetchSpan.isActive())
+    {
+        auto ms = [&](Clock::duration d) { return std::to_string(toMs(d)); };
+        fetchSpan.setArgs("{\"rows\":" + std::to_string(totalRows) +
+                          ",\"bytes\":" + std::to_string(totalBytes) +
+                          ",\"next_ms\":" + ms(nextTime) +
+                          ",\"decode_ms\":" + ms(convertTime) + "}");
+    }
+
+    PerfStats::instance().recordFetch(totalRows, totalBytes);
+    return stoppedEarly;
+}
+
+static std::string quoteIdentifier(const std::string& name)
+{
+    std::string quoted = "`";
+    for (char c : name)
+    {
+        if (c == '`')
+            quoted += '`';
+        quoted += c;
+    }
+    return quoted + "`";
+}
+
+// Znaki specjalne LIKE traktowane dosłownie
+static std::string escapeLike(const std::string& text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        if (c == '\\' || c == '%' || c == '_')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+static std::string trim(const std::string& text)
+{
+    const size_t first = text.find_first_not_of(" \t");
+    if (first == std::string::npos)
+        return {};
+    const size_t last = text.find_last_not_of(" \t");
+    return text.substr(first, last - first + 1);
+}
+
+// Warunek WHERE dla filtra kolumny (składnia opisana przy ColumnFilter); wartości jako parametry
+static std::string buildFilterCondition(const ColumnFilter& filter, std::vector<std::string>& params)
+{
+    const std::string column = quoteIdentifier(filter.column);
+    const std::string text = trim(filter.text);
+
+    std::string lower = text;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
+    if (lower == "null")
+        return column + " IS NULL";
+    if (lower == "!null")
+        return column + " IS NOT NULL";
+
+    static const char* const operators[] = { ">=", "<=", "!=", "<>", "=", ">", "<" };
+    for (const char* op : operators)
+    {
+        const std::string prefix = op;
+        if (text.rfind(prefix, 0) == 0)
+        {
+            params.push_back(trim(text.substr(prefix.size())));
+            return column + " " + (prefix == "!=" ? "<>" : prefix) + " ?";
+        }
+    }
+
+    if (text[0] == '~')
+    {
+        params.push_back("%" + escapeLike(text.substr(1)) + "%");
+        return column + " LIKE ?";
+    }
+
+    params.push_back(escapeLike(text) + "%");
+    return column + " LIKE ?";
+}
+
+// Warunek "wiersz leży za kluczem" w porządku (sort, pk). MariaDB sortuje NULL jako najmniejsze:
+// przy ASC są na początku, przy DESC na końcu.
+static std::string buildAfterCondition(const std::string& sort, const std::string& pk, bool descending,
+                                       const PageKey& key, std::vector<std::string>& params)
+{
+    const char* pkOp = descending ? "<" : ">";
+    const char* sortOp = descending ? "<" : ">";
+
+    if (!key.sortValue)
+    {
+        params.push_back(key.pk);
+        if (descending) // NULL na końcu - dalej tylko NULL z mniejszym pk
+            return "(" + sort + " IS NULL AND " + pk + " " + pkOp + " ?)";
+        return "((" + sort + " IS NULL AND " + pk + " " + pkOp + " ?) OR " + sort + " IS NOT NULL)";
+    }
+
+    params.push_back(*key.sortValue);
+    params.push_back(*key.sortValue);
+    params.push_back(key.pk);
+    std::string condition = "(" + sort + " " + sortOp + " ? OR (" + sort + " = ? AND " + pk + " " + pkOp + " ?)";
+    if (descending)
+        condition += " OR " + sort + " IS NULL";
+    return condition + ")";
+}
+
+// Warunek "wiersz leży przed kluczem lub na nim" - górna granica strony
+static std::string buildUpToCondition(const std::string& sort, const std::string& pk, bool descending,
+                                      const PageKey& key, std::vector<std::string>& params)
+{
+    const char* pkOp = descending ? ">=" : "<=";
+    const char* sortOp = descending ? ">" : "<";
+
+    if (!key.sortValue)
+    {
+        params.push_back(key.pk);
+        if (descending)
+            return "(" + sort + " IS NOT NULL OR " + pk + " " + pkOp + " ?)";
+        return "(" + sort + " IS NULL AND " + pk + " " + pkOp + " ?)";
+    }
+
+    params.push_back(*key.sortValue);
+    params.push_back(*key.sortValue);
+    params.push_back(key.pk);
+    std::string condition = "(" + sort + " " + sortOp + " ? OR (" + sort + " = ? AND " + pk + " " + pkOp + " ?)";
+    if (!descending)
+        condition += " OR " + sort + " IS NULL";
+    return condition + ")";
+}
+
+// SELECT z filtrami, sortowaniem i (gdy podano pk) granicami strony keyset
+static std::string buildBrowseSql(const std::string& tableName, const std::string& pkColumn, const TableQuery& query,
+                                  const std::optional<PageKey>& afterKey, const std::optional<PageKey>& upToKey,
+                                  size_t limit, std::vector<std::string>& params)
+{
+    std::vector<std::string> conditions;
+    for (const ColumnFilter& filter : query.filters)
+    {
+        if (!trim(filter.text).empty())
+            conditions.push_back(buildFilterCondition(filter, params));
+    }
+
+    std::string orderBy;
+    if (!pkColumn.empty())
+    {
+        const std::string pk = quoteIdentifier(pkColumn);
+        const char* direction = query.descending ? " DESC" : "";
+
+        if (!query.sortColumn.empty() && query.sortColumn != pkColumn)
+        {
+            // Porządek (sort, pk) - pk rozstrzyga remisy, więc granica strony jest jednoznaczna
+            const std::string sort = quoteIdentifier(query.sortColumn);
+            if (afterKey)
+                conditions.push_back(buildAfterCondition(sort, pk, query.descending, *afterKey, params));
+            if (upToKey)
+                conditions.push_back(buildUpToCondition(sort, pk, query.descending, *upToKey, params));
+            orderBy = sort + direction + ", " + pk + direction;
+        }
+        else
+        {
+            if (afterKey)
+            {
+                conditions.push_back(pk + (query.descending ? " < ?" : " > ?"));
+                params.push_back(afterKey->pk);
+            }
+            if (upToKey)
+            {
+                conditions.push_back(pk + (query.descending ? " >= ?" : " <= ?"));
+                params.push_back(upToKey->pk);
+            }
+            orderBy = pk + direction;
+        }
+    }
+    else if (!query.sortColumn.empty())
+    {
+        orderBy = quoteIdentifier(query.sortColumn) + (query.descending ? " DESC" : "");
+    }
+
+    std::string sql;
+    if (query.limits.maxStatementSeconds > 0)
+        sql = "SET STATEMENT max_statement_time=" + std::to_string(query.limits.maxStatementSeconds) + " FOR ";
+    sql += "SELECT * FROM " + quoteIdentifier(tableName);
+    for (size_t i = 0; i < conditions.size(); ++i)
+        sql += (i == 0 ? " WHERE " : " AND ") + conditions[i];
+    if (!orderBy.empty())
+        sql += " ORDER BY " + orderBy;
+    if (limit > 0)
+        sql += " LIMIT " + std::to_string(limit);
+    return sql;
+}
+
+// Pełne pobranie tabeli czyta co najwyżej maxRows + 1 wierszy - nadmiarowy wiersz oznacza obcięty wynik
+static size_t rowCapLimit(const QueryLimits& limits)
+{
+    return limits.maxRows > 0 ? limits.maxRows + 1 : 0;
+}
+
+// Pobranie bez żadnego limitu może czytać całą tabelę do pamięci - tylko na wyraźne życzenie
+static void requireBoundedLimits(const std::string& tableName, const QueryLimits& limits)
+{
+    if (limits.isUnbounded() && !limits.allowUnbounded)
+        throw std::runtime_error("Refusing to load " + tableName + " with no row or memory limit; "
+                                 "set a limit or allow unlimited results");
+}
+
+// Pobiera dane z wybranej tabeli (z opcjonalnym sortowaniem i filtrami po stronie serwera)
+TableData getTableData(DbConnection& conn, const std::string& tableName, const TableQuery& query)
+{
+    TRACE_SCOPE_CAT("getTableData", "db");
+    TableData tableData;
+    try 
+    {
+        std::vector<std::string> params;
+        const std::string sql = buildBrowseSql(tableName, {}, query, std::nullopt, std::nullopt, rowCapLimit(query.limits), params);
+        std::unique_ptr<RowSource> res = conn.execute(sql, params);
+        readResultSet(*res, tableData, nullptr, nullptr, &query.limits);
+    } 
+    catch (sql::SQLException& e) 
+    {
+        std::cerr << "Error with getting data from tables: " << tableName << ": " << e.what() << std::endl;
+    }
+
+    return tableData;
+}
+
+TableData getTableData(sql::Connection& conn, const std::string& tableName, const TableQuery& query)
+{
+    return withMariaDb(conn, [&](DbConnection& db) { return getTableData(db, tableName, query); });
+}
+
+void streamTableData(DbConnection& conn, const std::string& tableName, const TableQuery& query, size_t fetchSize,
+                     const RowBatchCallback& onBatch, const EarlyStopCallback& onEarlyStop)
+{
+    TRACE_SCOPE_CAT("streamTableData", "db");
+    requireBoundedLimits(tableName, query.limits);
+
+    std::vector<std::string> params;
+    const std::string sql = buildBrowseSql(tableName, {}, query, std::nullopt, std::nullopt, rowCapLimit(query.limits), params);
+
+    std::unique_ptr<RowSource> res = conn.execute(sql, params, std::max<size_t>(fetchSize, 1));
+    TableData tableData;
+    if (readResultSet(*res, tableData, nullptr, &onBatch, &query.limits) && onEarlyStop)
+        onEarlyStop();
+}
+
+void streamTableData(sql::Connection& conn, const std::string& tableName, const TableQuery& query, size_t fetchSize,
+                     const RowBatchCallback& onBatch, const EarlyStopCallback& onEarlyStop)
+{
+    withMariaDb(conn, [&](DbConnection& db) { streamTableData(db, tableName, query, fetchSize, onBatch, onEarlyStop); });
+}
+
+void streamTableData(DbSession& session, const std::string& tableName, const TableQuery& query, size_t fetchSize,
+                     const RowBatchCallback& onBatch)
+{
+    bool killed = false;
+    streamTableData(session.connection(), tableName, query, fetchSize, onBatch, [&]() { killed = session.killQuery(); });
+    // Wynik już zamknięty; przerwane połączenie nie wraca do puli
+    if (killed)
+        session.reconnect();
+}
+
+// Pobiera stronę wierszy metodą keyset w porządku (query.sortColumn, pk): wiersze za afterKey
+// (oraz nie dalej niż upToKey), z filtrami z query. limit == 0 oznacza brak LIMIT (strona ograniczona z obu stron kluczami).
+// W przeciwieństwie do getTableData błędy są rzucane dalej - pusta strona oznaczałaby koniec tabeli.
+TableData getTablePage(DbConnection& conn, const std::string& tableName, const std::string& pkColumn, const TableQuery& query,
+                       const std::optional<PageKey>& afterKey, const std::optional<PageKey>& upToKey, size_t limit)
+{
+    TRACE_SCOPE_CAT("getTablePage", "db");
+    std::vector<std::string> params;
+    const std::string sql = buildBrowseSql(tableName, pkColumn, query, afterKey, upToKey, limit, params);
+
+    TableData tableData;
+    std::unique_ptr<RowSource> res = conn.execute(sql, params);
+    readResultSet(*res, tableData);
+    return tableData;
+}
+
+TableData getTablePage(sql::Connection& conn, const std::string& tableName, const std::string& pkColumn, const TableQuery& query,
+                       const std::optional<PageKey>& afterKey, const std::optional<PageKey>& upToKey, size_t limit)
+{
+    return withMariaDb(conn, [&](DbConnection& db) { return getTablePage(db, tableName, pkColumn, query, afterKey, upToKey, limit); });
+}
+
+static uint64_t querySessionBytesSent(sql::Connection& conn)
+{
+    std::unique_ptr<sql::Statement> stmt(conn.createStatement());
+    std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SHOW SESSION STATUS LIKE 'Bytes_sent'"));
+    return res->next() ? static_cast<uint64_t>(std::stoull(res->getString(2).c_str())) : 0;
+}
+
+FetchBenchmark benchmarkTableFetch(sql::Connection& conn, const std::string& tableName, const QueryLimits& limits,
+                                   const std::function<bool()>& isCancelled)
+{
+    TRACE_SCOPE_CAT("benchmarkTableFetch", "db");
+    using Clock = std::chrono::steady_clock;
+    requireBoundedLimits(tableName, limits);
+
+    TableQuery query;
+    query.limits = limits;
+    std::vector<std::string> params;
+    const std::string sql = buildBrowseSql(tableName, {}, query, std::nullopt, std::nullopt, rowCapLimit(limits), params);
+
+    // Dwa odczyty z rzędu dają narzut samego SHOW STATUS, odejmowany od wyniku
+    const uint64_t before = querySessionBytesSent(conn);
+    const uint64_t baseline = querySessionBytesSent(conn);
+    const uint64_t statusOverhead = baseline - before;
+
+    FetchBenchmark result;
+    MariaDbConnection adapter(conn);
+    const Clock::time_point start = Clock::now();
+    std::unique_ptr<RowSource> res = adapter.execute(sql, params);
+    result.executeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // Partie są tylko liczone - pamięć nie rośnie z rozmiarem tabeli, budżet bajtów działa jak przy przeglądaniu
+    const RowBatchCallback countRows = [&](TableData&& batch)
+    {
+        result.rows += batch.getRowCount();
+        if (!batch.getTruncation().empty())
+            result.truncation = batch.getTruncation();
+        return !isCancelled || !isCancelled();
+    };
+    TableData tableData;
+    FetchTimings timings;
+    readResultSet(*res, tableData, &timings, &countRows, &limits);
+    res.reset();
+
+    const uint64_t after = querySessionBytesSent(conn);
+    result.bytesSent = after - baseline > statusOverhead ? after - baseline - statusOverhead : 0;
+    result.nextMs = timings.nextMs;
+    result.decodeMs = timings.decodeMs;
+    return result;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "DbBackend.h"
+#include "TableData.h"
+#include "TableQuery.h"
+#include <mariadb/conncpp.hpp>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+class DbSession;
+
+// Tabela bieżącej bazy ze statystykami z information_schema.TABLES. Dla InnoDB liczba wierszy
+// jest szacunkowa (może się różnić o kilkadziesiąt procent), ale wystarcza do oceny rzędu wielkości.
+struct TableInfo
+{
+    std::string name;
+    bool hasStats = false;   // widoki nie mają statystyk
+    uint64_t approxRows = 0;
+    uint64_t dataBytes = 0;
+    uint64_t indexBytes = 0;
+};
+
+// Funkcje synchroniczne - do wywołania w wątku bazy (wewnątrz zadania DbExecutor).
+// Wersje z DbConnection działają na dowolnym backendzie (np. FakeBackend w benchmarku);
+// wersje z sql::Connection to ta sama ścieżka na połączeniu MariaDB.
+std::vector<TableInfo> getTablesFromDatabase(DbConnection& conn);
+std::vector<TableInfo> getTablesFromDatabase(sql::Connection& conn);
+TableData getTableData(DbConnection& conn, const std::string& tableName, const TableQuery& query = {});
+TableData getTableData(sql::Connection& conn, const std::string& tableName, const TableQuery& query = {});
+// Odbiorca partii wierszy w trybie strumieniowym (wątek bazy); false przerywa pobieranie
+using RowBatchCallback = std::function<bool(TableData&& batch)>;
+// Wołane przed zamknięciem wyniku strumieniowego, gdy czytanie skończyło się przed jego końcem (budżet pamięci,
+// onBatch zwrócił false). Zamknięcie wyniku przeczytałoby z sieci wszystkie pozostałe wiersze - tu można je przerwać
+using EarlyStopCallback = std::function<void()>;
+// Strumieniowa wersja getTableData: wynik forward-only czytany z serwera po fetchSize wierszy, a partie
+// trafiają do onBatch w miarę nadchodzenia - pierwsza po pierwszym ekranie wierszy. Zawsze co najmniej
+// jedna partia (z nagłówkami). Bez limitu wierszy i pamięci naraz tylko z QueryLimits::allowUnbounded.
+// Błędy są rzucane dalej.
+void streamTableData(DbConnection& conn, const std::string& tableName, const TableQuery& query, size_t fetchSize,
+                     const RowBatchCallback& onBatch, const EarlyStopCallback& onEarlyStop = {});
+void streamTableData(sql::Connection& conn, const std::string& tableName, const TableQuery& query, size_t fetchSize,
+                     const RowBatchCallback& onBatch, const EarlyStopCallback& onEarlyStop = {});
+// Strumień na połączeniu sesji: przy wcześniejszym końcu zapytanie jest przerywane na serwerze (KILL QUERY),
+// a sesja dostaje nowe połączenie zamiast czekać na resztę wyniku
+void streamTableData(DbSession& session, const std::string& tableName, const TableQuery& query, size_t fetchSize,
+                     const RowBatchCallback& onBatch);
+TableData getTablePage(DbConnection& conn, const std::string& tableName, const std::string& pkColumn, const TableQuery& query,
+                       const std::optional<PageKey>& afterKey, const std::optional<PageKey>& upToKey, size_t limit);
+TableData getTablePage(sql::Connection& conn, const std::string& tableName, const std::string& pkColumn, const TableQuery& query,
+                       const std::optional<PageKey>& afterKey, const std::optional<PageKey>& upToKey, size_t limit);
+
+// Jedno pobranie tabeli z pomiarami - porównanie protokołu tekstowego i binarnego.
+// Zapytanie jak przy przeglądaniu: z limitami czasu, wierszy i pamięci; wiersze są tylko liczone, nie trzymane.
+// isCancelled (wołane co partię) przerywa czytanie wyniku.
+// Protokół wynika z połączenia (DbEndpoint::serverPrepared). Błędy są rzucane dalej.
+struct FetchBenchmark
+{
+    size_t rows = 0;
+    std::string truncation; // opis obcięcia wyniku przez limity; "" - cały wynik
+    uint64_t bytesSent = 0; // przyrost Bytes_sent sesji na serwerze (bez narzutu samego SHOW STATUS)
+    double executeMs = 0.0; // prepare + executeQuery
+    double nextMs = 0.0;    // next() - odczyt i parsowanie wierszy przez konektor
+    double decodeMs = 0.0;  // get*() i zapis do TableData
+};
+FetchBenchmark benchmarkTableFetch(sql::Connection& conn, const std::string& tableName, const QueryLimits& limits,
+                                   const std::function<bool()>& isCancelled = {});
@@ -1,136 +1,40 @@
 #include "TableOperations.h"
 #include <iostream>
-#include <set>
-#include <map>
+#include <memory>
 #include <vector>
 #include <cstring>
 #include <algorithm>
-#include <cctype>
+#include <cfloat>
 #include "imgui/imgui.h"
 
-static std::string to_lower(std::string s) 
+// Pole tekstowe na std::string z ograniczonym buforem, jak w formularzach ImGui
+static bool inputTextString(const char* label, std::string& value)
 {
-    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){ return std::tolower(c); });
-    return s;
+    char buf[256];
+    std::memset(buf, 0, sizeof(buf));
+    std::strncpy(buf, value.c_str(), sizeof(buf) - 1);
+
+    if (!ImGui::InputText(label, buf, sizeof(buf)))
+        return false;
+    value = buf;
+    return true;
 }
 
-static bool parse_server_function_literal(const std::string& in, std::string& outExpr) 
-{
-    std::string s = to_lower(in);
-    // Usuń spacje z początku/końca
-    auto ltrim = [](std::string& x){ x.erase(x.begin(), std::find_if(x.begin(), x.end(), [](unsigned char c){ return !std::isspace(c);})); };
-    auto rtrim = [](std::string& x){ x.erase(std::find_if(x.rbegin(), x.rend(), [](unsigned char c){ return !std::isspace(c);}).base(), x.end()); };
-    std::string t = s;
-    ltrim(t); rtrim(t);
-
-    auto is_name_or_call = [&](const std::string& name)->bool
-    {
-        return (t == name) || (t == name + "()"); 
-    };
-
-    if (is_name_or_call("current_timestamp")) { outExpr = "CURRENT_TIMESTAMP"; return true; }
-    if (is_name_or_call("now"))               { outExpr = "NOW()"; return true; }
-    if (is_name_or_call("curdate"))           { outExpr = "CURDATE()"; return true; }
-    if (is_name_or_call("curtime"))           { outExpr = "CURTIME()"; return true; }
-
-    return false;
-}
-
-void getHeadersFromTable(sql::Connection& conn, const std::string& tableName, std::vector<std::string>& headers)
-{
-    try 
-    {
-        std::unique_ptr<sql::Statement> stmt(conn.createStatement());
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT * FROM " + tableName + " LIMIT 1"));
-
-        sql::ResultSetMetaData* meta = res->getMetaData();
-        int columnCount = meta->getColumnCount();
-
-        headers.clear();
-        headers.reserve(columnCount);
-        for (int i = 1; i <= columnCount; ++i)
-            headers.push_back(meta->getColumnName(i).c_str());
-    } 
-    catch (sql::SQLException& e) 
-    {
-        std::cerr << "Błąd podczas pobierania nagłówków z tabeli " << tableName << ": " << e.what() << std::endl;
-    }
-}
-
-std::string getPKFromTable(sql::Connection& conn, const std::string& tableName)
-{
-    try 
-    {
-        std::unique_ptr<sql::Statement> stmt(conn.createStatement());
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery(
-            "SELECT COLUMN_NAME "
-            "FROM INFORMATION_SCHEMA.COLUMNS "
-            "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = '" + tableName + "' "
-            "AND COLUMN_KEY = 'PRI';"));
-
-        if (res->next())
-        {
-            return res->getString("COLUMN_NAME").c_str();
-        }
-    } 
-    catch (sql::SQLException& e) 
-    {
-        std::cerr << "Error with getting primary_key data from table: " << tableName << ": " << e.what() << std::endl;
-    }
-
-    return "";
-}
-
-void addRowToTable(sql::Connection& conn, const std::string& tableName)
+void addRowToTable(DbExecutor& db, const std::string& tableName, const RowsChangedCallback& onRowsChanged)
 {
     if (tableName.empty())
         return;
 
-    static std::map<std::string, std::vector<std::string>> inputValues;
-    static std::map<std::string, std::vector<std::string>> columnNames;
+    static std::vector<std::string> cols;     // kolumny bez auto_increment
+    static std::vector<std::string> values;   // pola startowo wypełnione tekstem default
+    static std::vector<std::string> defaults; // wartości startowe nowych wierszy w trybie wsadowym
+    static std::vector<std::vector<std::string>> batchRows; // wiersze zebrane w trybie wsadowym
+    static bool batchMode = false;
+    static uint64_t formRequest = 0;          // odrzuca odpowiedzi dla poprzednio otwartego formularza
     static std::string lastError;
-
-    // Wczytanie listy kolumn (bez auto_increment) i domyślnych tylko raz na tabelę
-    if (columnNames.find(tableName) == columnNames.end())
-    {
-        std::vector<std::string> cols;
-        std::vector<std::string> defaults;
-
-        try
-        {
-            std::unique_ptr<sql::ResultSet> res(conn.createStatement()->executeQuery(
-                "SELECT COLUMN_NAME, COLUMN_DEFAULT, EXTRA "
-                "FROM INFORMATION_SCHEMA.COLUMNS "
-                "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = '" + tableName + "' "
-                "ORDER BY ORDINAL_POSITION;"
-            ));
-
-            while (res->next())
-            {
-                std::string extra = static_cast<std::string>(res->getString("EXTRA"));
-                if (extra.find("auto_increment") != std::string::npos)
-                    continue;
-
-                std::string col = static_cast<std::string>(res->getString("COLUMN_NAME"));
-                std::string def = res->isNull("COLUMN_DEFAULT") ? "" : static_cast<std::string>(res->getString("COLUMN_DEFAULT"));
-
-                cols.push_back(col);
-                defaults.push_back(def);
-            }
-        }
-        catch (sql::SQLException& e)
-        {
-            std::cerr << "Błąd przy pobieraniu definicji kolumn dla tabeli " << tableName << ": " << e.what() << std::endl;
-        }
-
-        columnNames[tableName] = std::move(cols);
-        inputValues[tableName] = std::move(defaults); // pola startowo wypełnione tekstem default
-    }
-
-    auto& cols   = columnNames[tableName];
-    auto& values = inputValues[tableName];
-    if (values.size() != cols.size())
-        values.resize(cols.size());
+    static bool loadingColumns = false;
+    static bool saving = false;
+    static bool closeRequested = false;
 
     const ImGuiViewport* vp = ImGui::GetMainViewport();
     ImGui::SetNextWindowPos(vp->GetCenter(), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
@@ -138,158 +42,183 @@ void addRowToTable(sql::Connection& conn, const std::string& tableName)
     if (ImGui::BeginPopupModal(ADD_ROW_POPUP_ID, nullptr,
                                ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove))
     {
-        for (size_t i = 0; i < cols.size(); ++i)
-        {
-            std::string label = cols[i] + "##" + std::to_string(i);
-            char buf[256];
-            std::memset(buf, 0, sizeof(buf));
-            std::strncpy(buf, values[i].c_str(), sizeof(buf) - 1);
-
-            if (ImGui::InputText(label.c_str(), buf, sizeof(buf)))
-                values[i] = buf;
-        }
-
-        if (!lastError.empty())
-            ImGui::TextColored(ImVec4(1,0,0,1), "Błąd: %s", lastError.c_str());
-
-        ImGui::Separator();
-
-        if (ImGui::Button("OK", ImVec2(120,0)))
+        // Formularz budowany przy każdym otwarciu z SchemaCache - bez zapytania, gdy schemat jest w pamięci
+        if (ImGui::IsWindowAppearing())
         {
-            try
-            {
-                std::set<std::string> autoIncrementCols;
-                std::set<std::string> hasDefaultCols;
-
-                std::unique_ptr<sql::ResultSet> defRes(conn.createStatement()->executeQuery(
-                    "SELECT COLUMN_NAME, COLUMN_DEFAULT, EXTRA "
-                    "FROM INFORMATION_SCHEMA.COLUMNS "
-                    "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = '" + tableName + "' "
-                    "ORDER BY ORDINAL_POSITION;"
-                ));
-
-                while (defRes->next())
-                {
-                    std::string colName = static_cast<std::string>(defRes->getString("COLUMN_NAME"));
-                    std::string extra   = static_cast<std::string>(defRes->getString("EXTRA"));
-
-                    if (!defRes->isNull("COLUMN_DEFAULT"))
-                        hasDefaultCols.insert(colName);
-
-                    if (extra.find("auto_increment") != std::string::npos)
-                        autoIncrementCols.insert(colName);
-                }
-
-                enum class ValKind { Param, ServerFunc, UseDefault };
-
-                std::vector<std::string> insertCols;
-                std::vector<ValKind>     kinds;
-                std::vector<std::string> serverExpr;   // dla ServerFunc: dosłowny tekst funkcji do wstrzyknięcia (np. CURRENT_TIMESTAMP)
-                std::vector<std::string> paramValues;  // dla Param: wartości bindowane
-
-                insertCols.reserve(cols.size());
-                kinds.reserve(cols.size());
-                serverExpr.reserve(cols.size());
-                paramValues.reserve(cols.size());
+            const uint64_t request = ++formRequest;
+            cols.clear();
+            values.clear();
+            defaults.clear();
+            batchRows.clear();
+            lastError.clear();
+            loadingColumns = true;
 
-                for (size_t i = 0; i < cols.size(); ++i)
+            db.submit(
+                [tableName](DbSession& session) { return requireTableSchema(session, tableName); },
+                [request](DbResult<std::shared_ptr<const TableSchema>>& result)
                 {
-                    const std::string& colName = cols[i];
-                    if (autoIncrementCols.count(colName))
-                        continue;
+                    if (request != formRequest)
+                        return;
 
-                    std::string v = values[i];
-                    // Jeśli puste i kolumna ma default, użyj DEFAULT
-                    if (v.empty() && hasDefaultCols.count(colName))
+                    loadingColumns = false;
+                    if (!result.ok())
                     {
-                        insertCols.push_back(colName);
-                        kinds.push_back(ValKind::UseDefault);
-                        serverExpr.emplace_back(); // placeholder
-                        continue;
+                        lastError = result.error;
+                        return;
                     }
 
-                    // Jeśli użytkownik wpisał "default" (dowolna wielkość liter) -> DEFAULT
-                    if (to_lower(v) == "default")
+                    for (const auto& column : result.value->columns)
                     {
-                        insertCols.push_back(colName);
-                        kinds.push_back(ValKind::UseDefault);
-                        serverExpr.emplace_back();
-                        continue;
-                    }
-
-                    // Rozpoznaj funkcje serwera niezależnie od case
-                    std::string expr;
-                    if (parse_server_function_literal(v, expr))
-                    {
-                        insertCols.push_back(colName);
-                        kinds.push_back(ValKind::ServerFunc);
-                        serverExpr.push_back(expr);
-                        continue;
+                        if (column.autoIncrement)
+                            continue;
+                        cols.push_back(column.name);
+                        defaults.push_back(column.defaultValue.value_or(""));
                     }
+                    values = defaults;
+                });
+        }
 
-                    // W przeciwnym razie zwykły parametr
-                    insertCols.push_back(colName);
-                    kinds.push_back(ValKind::Param);
-                    serverExpr.emplace_back();
-                    paramValues.push_back(v);
-                }
+        if (closeRequested)
+        {
+            closeRequested = false;
+            ImGui::CloseCurrentPopup();
+        }
 
-                std::string sql = "INSERT INTO " + tableName + " (";
-                for (size_t i = 0; i < insertCols.size(); ++i)
-                {
-                    sql += insertCols[i];
-                    if (i + 1 < insertCols.size()) sql += ", ";
-                }
-                sql += ") VALUES (";
-                size_t nextParamIndex = 1;
-                size_t nextParamToBind = 0;
+        if (loadingColumns)
+            ImGui::TextDisabled("Loading columns...");
 
-                for (size_t i = 0; i < kinds.size(); ++i)
-                {
-                    if (kinds[i] == ValKind::UseDefault)
-                        sql += "DEFAULT";
-                    else if (kinds[i] == ValKind::ServerFunc)
-                        sql += serverExpr[i];
-                    else // Param
-                        sql += "?";
-
-                    if (i + 1 < kinds.size()) sql += ", ";
-                }
-                sql += ");";
+        // Po włączeniu trybu wsadowego bieżący formularz staje się pierwszym wierszem siatki
+        if (ImGui::Checkbox("Batch mode", &batchMode) && batchMode && batchRows.empty() && !cols.empty())
+            batchRows.push_back(values);
 
-                std::unique_ptr<sql::PreparedStatement> pstmt(conn.prepareStatement(sql));
+        if (!batchMode)
+        {
+            for (size_t i = 0; i < cols.size(); ++i)
+            {
+                std::string label = cols[i] + "##" + std::to_string(i);
+                inputTextString(label.c_str(), values[i]);
+            }
+        }
+        else if (!cols.empty())
+        {
+            // Edytowalna siatka: wiersz = jeden VALUES (...), ostatnia kolumna usuwa wiersz
+            const int columnCount = static_cast<int>(cols.size()) + 1;
+            const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY |
+                                          ImGuiTableFlags_ScrollX | ImGuiTableFlags_SizingFixedFit;
+            const ImVec2 gridSize(std::min(140.0f * static_cast<float>(columnCount), vp->WorkSize.x * 0.8f), 260.0f);
 
-                // Bindowanie tylko dla parametrów
-                for (size_t i = 0; i < kinds.size(); ++i)
+            if (ImGui::BeginTable("##BatchRows", columnCount, flags, gridSize))
+            {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                for (const auto& col : cols)
+                    ImGui::TableSetupColumn(col.c_str(), ImGuiTableColumnFlags_WidthFixed, 120.0f);
+                ImGui::TableSetupColumn("##remove", ImGuiTableColumnFlags_WidthFixed, 24.0f);
+                ImGui::TableHeadersRow();
+
+                size_t removeRow = batchRows.size();
+                for (size_t r = 0; r < batchRows.size(); ++r)
                 {
-                    if (kinds[i] == ValKind::Param)
+                    ImGui::PushID(static_cast<int>(r));
+                    ImGui::TableNextRow();
+                    for (size_t c = 0; c < cols.size(); ++c)
                     {
-                        if (nextParamToBind >= paramValues.size())
-                            throw std::runtime_error("Internal binding error: value index out of range.");
-                        pstmt->setString(static_cast<int>(nextParamIndex++), paramValues[nextParamToBind++]);
+                        ImGui::TableNextColumn();
+                        ImGui::PushID(static_cast<int>(c));
+                        ImGui::SetNextItemWidth(-FLT_MIN);
+                        inputTextString("##cell", batchRows[r][c]);
+                        ImGui::PopID();
                     }
-                }
 
-                pstmt->execute();
+                    ImGui::TableNextColumn();
+                    if (ImGui::SmallButton("x"))
+                        removeRow = r;
+                    ImGui::PopID();
+                }
+                ImGui::EndTable();
 
-                values.assign(values.size(), "");
-                lastError.clear();
-                ImGui::CloseCurrentPopup();
+                if (removeRow < batchRows.size())
+                    batchRows.erase(batchRows.begin() + static_cast<std::ptrdiff_t>(removeRow));
             }
-            catch (const std::exception& e)
+
+            if (ImGui::Button("Add row"))
+                batchRows.push_back(defaults);
+            ImGui::SameLine();
+            ImGui::Text("%zu row(s) queued", batchRows.size());
+        }
+
+        if (!lastError.empty())
+            ImGui::TextColored(ImVec4(1,0,0,1), "Błąd: %s", lastError.c_str());
+
+        ImGui::Separator();
+
+        if (saving)
+        {
+            ImGui::TextDisabled("Saving...");
+        }
+        else if (!batchMode)
+        {
+            if (ImGui::Button("OK", ImVec2(120,0)) && !loadingColumns)
             {
-                lastError = e.what();
+                saving = true;
+                db.submit(
+                    [tableName, insertCols = cols, insertValues = values](DbSession& session)
+                    {
+                        auto schema = requireTableSchema(session, tableName);
+                        return insertRow(session, *schema, insertCols, insertValues);
+                    },
+                    [tableName, onRowsChanged](DbResult<bool>& result)
+                    {
+                        saving = false;
+                        if (!result.ok())
+                        {
+                            lastError = result.error;
+                            return;
+                        }
+
+                        values = defaults;
+                        lastError.clear();
+                        closeRequested = true;
+                        if (onRowsChanged)
+                            onRowsChanged(tableName);
+                    });
             }
-            catch (sql::SQLException& e)
+        }
+        else
+        {
+            const std::string label = "Insert " + std::to_string(batchRows.size()) + " row(s)";
+            if (ImGui::Button(label.c_str(), ImVec2(160,0)) && !loadingColumns && !batchRows.empty())
             {
-                lastError = e.what();
+                saving = true;
+                db.submit(
+                    [tableName, insertCols = cols, rows = batchRows](DbSession& session)
+                    {
+                        auto schema = requireTableSchema(session, tableName);
+                        sql::Connection& conn = session.connection();
+                        return insertRows(conn, *schema, insertCols, rows, queryMaxAllowedPacket(conn));
+                    },
+                    [tableName, onRowsChanged](DbResult<size_t>& result)
+                    {
+                        saving = false;
+                        if (!result.ok())
+                        {
+                            lastError = result.error;
+                            return;
+                        }
+
+                        batchRows.clear();
+                        lastError.clear();
+                        closeRequested = true;
+                        if (onRowsChanged)
+                            onRowsChanged(tableName);
+                    });
             }
         }
 
         ImGui::SameLine();
         if (ImGui::Button("Cancel", ImVec2(120,0)))
         {
-            values.assign(values.size(), "");
+            values = defaults;
+            batchRows.clear();
             lastError.clear();
             ImGui::CloseCurrentPopup();
         }
@@ -298,114 +227,96 @@ void addRowToTable(sql::Connection& conn, const std::string& tableName)
     }
 }
 
-void deleteRowFromTable(sql::Connection& conn, const std::string& tableName, const std::string& pkColumn, const std::string& pkValue)
+void deleteRowFromTable(DbExecutor& db, const std::string& tableName, const std::string& pkColumn, const std::string& pkValue,
+                        const RowsChangedCallback& onRowsChanged)
 {
-    try
-    {
-        const std::string sql = "DELETE FROM `" + tableName + "` WHERE `" + pkColumn + "` = ? LIMIT 1;";
-        std::unique_ptr<sql::PreparedStatement> pstmt(conn.prepareStatement(sql));
-        pstmt->setString(1, pkValue);
-        pstmt->execute();
-    }
-    catch (sql::SQLException& e)
-    {
-        std::cerr << "Error deleting from table " << tableName
-                  << " by PK " << pkColumn << "=" << pkValue
-                  << ": " << e.what() << std::endl;
-    }
+    db.submit(
+        [tableName, pkColumn, pkValue](DbSession& session)
+        {
+            return deleteRow(session, tableName, pkColumn, pkValue);
+        },
+        [tableName, pkColumn, pkValue, onRowsChanged](DbResult<bool>& result)
+        {
+            if (!result.ok())
+            {
+                std::cerr << "Error deleting from table " << tableName
+                          << " by PK " << pkColumn << "=" << pkValue
+                          << ": " << result.error << std::endl;
+                return;
+            }
+
+            if (onRowsChanged)
+                onRowsChanged(tableName);
+        });
 }
 
-void updateRowInTable(sql::Connection& conn, const std::string& tableName, const std::string& pkColumn, const std::string& pkValue)
+void updateRowInTable(DbExecutor& db, const std::string& tableName, const std::string& pkColumn, const std::string& pkValue,
+                      const RowsChangedCallback& onRowsChanged)
 {
     if (tableName.empty())
         return;
 
-    static std::map<std::string, std::vector<std::string>> inputValues;
-    static std::map<std::string, std::vector<std::string>> columnNames;
-    static std::map<std::string, std::string> loadedPkForTable;  
+    static std::vector<std::string> cols;
+    static std::vector<std::string> values;
+    static uint64_t formRequest = 0; // odrzuca odpowiedzi dla poprzednio edytowanego wiersza
     static std::string lastError;
+    static bool loadingRow = false;
+    static CancelTokenPtr loadToken; // zamknięcie popupu przerywa odczyt wiersza
+    static bool saving = false;
+    static bool closeRequested = false;
 
-    if (columnNames.find(tableName) == columnNames.end())
-    {
-        std::vector<std::string> cols;
-        try
-        {
-            std::unique_ptr<sql::ResultSet> res(conn.createStatement()->executeQuery(
-                "SELECT COLUMN_NAME, EXTRA "
-                "FROM INFORMATION_SCHEMA.COLUMNS "
-                "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = '" + tableName + "' "
-                "ORDER BY ORDINAL_POSITION;"
-            ));
-
-            while (res->next())
-            {
-                std::string extra = static_cast<std::string>(res->getString("EXTRA"));
-                if (extra.find("auto_increment") != std::string::npos)
-                    continue;
-
-                cols.push_back(static_cast<std::string>(res->getString("COLUMN_NAME")));
-            }
-        }
-        catch (sql::SQLException& e)
-        {
-            std::cerr << "Błąd przy pobieraniu definicji kolumn dla tabeli " << tableName << ": " << e.what() << std::endl;
-        }
-
-        columnNames[tableName] = std::move(cols);
-        inputValues[tableName] = std::vector<std::string>(columnNames[tableName].size());
-        loadedPkForTable[tableName].clear();  
-    }
-
-    auto& cols   = columnNames[tableName];
-    auto& values = inputValues[tableName];
-    if (values.size() != cols.size())
-        values.resize(cols.size());
+    const ImGuiViewport* vp = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(vp->GetCenter(), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
 
-    if (loadedPkForTable[tableName] != pkValue && !pkColumn.empty())
+    if (ImGui::BeginPopupModal(UPDATE_ROW_POPUP_ID, nullptr,
+                               ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove))
     {
-        try
+        // Kolumny z SchemaCache i aktualne wartości wiersza - jedno zadanie przy otwarciu popupu
+        if (ImGui::IsWindowAppearing() && !pkColumn.empty())
         {
-            std::string sql = "SELECT ";
-            for (size_t i = 0; i < cols.size(); ++i)
-            {
-                sql += "`" + cols[i] + "`";
-                if (i + 1 < cols.size()) sql += ", ";
-            }
-            sql += " FROM `" + tableName + "` WHERE `" + pkColumn + "` = ? LIMIT 1;";
-
-            std::unique_ptr<sql::PreparedStatement> pstmt(conn.prepareStatement(sql));
-            pstmt->setString(1, pkValue);
-            std::unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+            const uint64_t request = ++formRequest;
+            cols.clear();
+            values.clear();
+            lastError.clear();
+            loadingRow = true;
+            loadToken = db.createCancelToken();
 
-            if (res->next())
-            {
-                for (size_t i = 0; i < cols.size(); ++i)
+            db.submit(
+                [tableName, pkColumn, pkValue](DbSession& session)
                 {
-                    if (res->isNull(static_cast<int>(i + 1)))
-                        values[i].clear();
-                    else
-                        values[i] = static_cast<std::string>(res->getString(static_cast<int>(i + 1)));
-                }
-            }
-            else
-            {
-                lastError = "Record not found (may have been deleted).";
-            }
+                    auto schema = requireTableSchema(session, tableName);
+                    return loadRowByPk(session, *schema, pkColumn, pkValue);
+                },
+                [request](DbResult<LoadedRow>& result)
+                {
+                    if (request != formRequest)
+                        return;
 
-            loadedPkForTable[tableName] = pkValue;
+                    loadingRow = false;
+                    loadToken.reset();
+                    if (!result.ok())
+                    {
+                        lastError = result.error;
+                        return;
+                    }
+
+                    cols = std::move(result.value.columns);
+                    values = std::move(result.value.values);
+                    if (!result.value.found)
+                        lastError = "Record not found (may have been deleted).";
+                },
+                loadToken);
         }
-        catch (sql::SQLException& e)
+
+        if (closeRequested)
         {
-            lastError = e.what();
+            closeRequested = false;
+            ImGui::CloseCurrentPopup();
         }
-    }
 
-    const ImGuiViewport* vp = ImGui::GetMainViewport();
-    ImGui::SetNextWindowPos(vp->GetCenter(), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+        if (loadingRow)
+            ImGui::TextDisabled("Loading row...");
 
-    if (ImGui::BeginPopupModal(UPDATE_ROW_POPUP_ID, nullptr,
-                               ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove))
-    {
         for (size_t i = 0; i < cols.size(); ++i)
         {
             std::string label = cols[i] + "##upd_" + std::to_string(i);
@@ -422,44 +333,45 @@ void updateRowInTable(sql::Connection& conn, const std::string& tableName, const
 
         ImGui::Separator();
 
-        if (ImGui::Button("OK", ImVec2(120,0)))
+        if (saving)
         {
-            try
-            {
-                std::string sql = "UPDATE `" + tableName + "` SET ";
-                for (size_t i = 0; i < cols.size(); ++i)
+            ImGui::TextDisabled("Saving...");
+        }
+        else if (ImGui::Button("OK", ImVec2(120,0)) && !loadingRow)
+        {
+            saving = true;
+            db.submit(
+                [tableName, updateCols = cols, updateValues = values, pkColumn, pkValue](DbSession& session)
                 {
-                    sql += "`" + cols[i] + "` = ?";
-                    if (i + 1 < cols.size()) sql += ", ";
-                }
-                sql += " WHERE `" + pkColumn + "` = ? LIMIT 1;";
-
-                std::unique_ptr<sql::PreparedStatement> pstmt(conn.prepareStatement(sql));
-
-                int bindIndex = 1;
-                for (size_t i = 0; i < cols.size(); ++i)
-                    pstmt->setString(bindIndex++, values[i]);
-
-                pstmt->setString(bindIndex, pkValue);
-
-                pstmt->execute();
+                    return updateRow(session, tableName, updateCols, updateValues, pkColumn, pkValue);
+                },
+                [tableName, onRowsChanged](DbResult<bool>& result)
+                {
+                    saving = false;
+                    if (!result.ok())
+                    {
+                        lastError = result.error;
+                        return;
+                    }
 
-                lastError.clear();
-                ImGui::CloseCurrentPopup();
-            }
-            catch (const std::exception& e)
-            {
-                lastError = e.what();
-            }
-            catch (sql::SQLException& e)
-            {
-                lastError = e.what();
-            }
+                    lastError.clear();
+                    closeRequested = true;
+                    if (onRowsChanged)
+                        onRowsChanged(tableName);
+                });
         }
 
         ImGui::SameLine();
         if (ImGui::Button("Cancel", ImVec2(120,0)))
         {
+            if (loadToken)
+            {
+                // Wiersz nie jest już potrzebny - odpowiedź zostanie odrzucona
+                loadToken->cancel();
+                loadToken.reset();
+                ++formRequest;
+                loadingRow = false;
+            }
             lastError.clear();
             ImGui::CloseCurrentPopup();
         }
@@ -1,18 +1,26 @@
 #pragma once
 
+#include "DbExecutor.h"
+#include "RowOperations.h"
 #include <mariadb/conncpp.hpp>
+#include <functional>
+#include <string>
+#include <vector>
 
 inline constexpr const char* ADD_ROW_POPUP_ID = "Add Row##AddRowModal";
 inline constexpr const char* UPDATE_ROW_POPUP_ID = "Update Row##UpdateRowModal";
 inline constexpr const char* CREATE_TABLE_POPUP_ID = "Create Table##CreateTableModal";
 inline constexpr const char* DELETE_TABLE_POPUP_ID = "Delete Table##DeleteTableModal";
 
-void addRowToTable(sql::Connection& conn, const std::string& tableName);
-void deleteRowFromTable(sql::Connection& conn, const std::string& tableName, const std::string& pkColumn, const std::string& pkValue);
-void updateRowInTable(sql::Connection& conn, const std::string& tableName, const std::string& pkColumn, const std::string& pkValue);
+// Wywoływany w wątku UI po udanej zmianie wierszy tabeli
+using RowsChangedCallback = std::function<void(const std::string& tableName)>;
+
+// Zapytania idą przez DbExecutor - popupy pokazują stan ładowania zamiast blokować klatkę
+void addRowToTable(DbExecutor& db, const std::string& tableName, const RowsChangedCallback& onRowsChanged);
+void deleteRowFromTable(DbExecutor& db, const std::string& tableName, const std::string& pkColumn, const std::string& pkValue,
+                        const RowsChangedCallback& onRowsChanged);
+void updateRowInTable(DbExecutor& db, const std::string& tableName, const std::string& pkColumn, const std::string& pkValue,
+                      const RowsChangedCallback& onRowsChanged);
 
 void createTableInDatabase(sql::Connection& conn, const std::string& tableName);
 void deleteTableFromDatabase(sql::Connection& conn, const std::string& tableName);
-
-void getHeadersFromTable(sql::Connection& conn, const std::string& tableName, std::vector<std::string>& outHeaders);
-std::string getPKFromTable(sql::Connection& conn, const std::string& tableName);
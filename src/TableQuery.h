@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Filtr jednej kolumny wpisany w wierszu filtrów widoku tabeli. Składnia tekstu:
+//   abc        - wartość zaczyna się od "abc" (LIKE 'abc%', może użyć indeksu)
+//   ~abc       - wartość zawiera "abc"
+//   =x !=x <x <=x >x >=x - porównanie
+//   null / !null - IS NULL / IS NOT NULL
+struct ColumnFilter
+{
+    std::string column;
+    std::string text;
+
+    bool operator==(const ColumnFilter& other) const { return column == other.column && text == other.text; }
+};
+
+// Limity bezpieczeństwa każdego zapytania przeglądania - np. przy pracy na replikach produkcyjnych.
+// Wartość 0 wyłącza dany limit. Po przekroczeniu wynik jest obcinany i oznaczany (TableData::getTruncation).
+// Strumień bez limitu wierszy i pamięci naraz wymaga jawnej zgody (allowUnbounded).
+struct QueryLimits
+{
+    double maxStatementSeconds = 30.0;      // SET STATEMENT max_statement_time=... FOR
+    size_t maxRows = 1000000;               // pełne pobranie tabeli: LIMIT maxRows + 1
+    size_t maxBytes = size_t{512} << 20;    // budżet danych TableData po stronie klienta
+    bool allowUnbounded = false;            // zgoda na maxRows == 0 i maxBytes == 0
+
+    bool isUnbounded() const { return maxRows == 0 && maxBytes == 0; }
+
+    bool operator==(const QueryLimits& other) const
+    {
+        return maxStatementSeconds == other.maxStatementSeconds && maxRows == other.maxRows && maxBytes == other.maxBytes &&
+               allowUnbounded == other.allowUnbounded;
+    }
+};
+
+// Sortowanie i filtry wykonywane po stronie serwera (ORDER BY / WHERE) oraz limity zapytania
+struct TableQuery
+{
+    std::string sortColumn; // "" - domyślna kolejność (klucz główny rosnąco)
+    bool descending = false;
+    std::vector<ColumnFilter> filters;
+    QueryLimits limits;
+
+    bool operator==(const TableQuery& other) const
+    {
+        return sortColumn == other.sortColumn && descending == other.descending && filters == other.filters &&
+               limits == other.limits;
+    }
+    bool operator!=(const TableQuery& other) const { return !(*this == other); }
+};
+
+// Pozycja wiersza w porządku (sortColumn, pk) - granica strony przy stronicowaniu keyset
+struct PageKey
+{
+    std::string pk;
+    std::optional<std::string> sortValue; // brak = NULL; używane tylko przy sortowaniu po kolumnie innej niż pk
+};
@@ -1,71 +1,34 @@
 #include "TableSelectionBar.h"
+#include <algorithm>
+#include <cstdio>
 #include "imgui/imgui.h"
 
-// Pobiera listę tabel z bazy danych
-std::vector<std::string> getTablesFromDatabase(sql::Connection& conn) 
+// Krótki zapis liczby wierszy: 950, 12.3K, 4.1M, 2.0G
+static std::string formatRowCount(uint64_t rows)
 {
-    std::vector<std::string> tables{};
-    try 
-    {
-        std::unique_ptr<sql::Statement> stmt(conn.createStatement());
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SHOW TABLES"));
-
-        // Pobiera nazwy tabel
-        while (res->next()) 
-        {
-            tables.push_back(res->getString(1).c_str());
-        }
-    } 
-    catch (sql::SQLException& e) 
-    {
-        std::cerr << "Error with getting tables: " << e.what() << std::endl;
-    }
-
-    return tables;
+    char text[32];
+    if (rows < 1000)
+        std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(rows));
+    else if (rows < 1000000)
+        std::snprintf(text, sizeof(text), "%.1fK", static_cast<double>(rows) / 1e3);
+    else if (rows < 1000000000)
+        std::snprintf(text, sizeof(text), "%.1fM", static_cast<double>(rows) / 1e6);
+    else
+        std::snprintf(text, sizeof(text), "%.1fG", static_cast<double>(rows) / 1e9);
+    return text;
 }
 
-// Pobiera dane z wybranej tabeli 
-TableData getTableData(sql::Connection& conn, const std::string& tableName)
+static double toMegabytes(uint64_t bytes)
 {
-    TableData tableData;
-    try 
-    {
-        std::unique_ptr<sql::Statement> stmt(conn.createStatement());
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT * FROM " + tableName));
-
-        sql::ResultSetMetaData* meta = res->getMetaData();
-        int columnCount = meta->getColumnCount();
-
-        // Pobiera nagłówki kolumn 
-        tableData.headers.reserve(columnCount);
-        for (int i = 1; i <= columnCount; ++i)
-            tableData.headers.push_back(meta->getColumnName(i).c_str());
-
-        // Pobiera wiersze danych
-        while (res->next())
-        {
-            Row row;
-            for (int i = 1; i <= columnCount; ++i) 
-            {
-                row.columns.push_back(res->getString(i).c_str());
-            }
-            tableData.rows.push_back(std::move(row));
-        }
-    } 
-    catch (sql::SQLException& e) 
-    {
-        std::cerr << "Error with getting data from tables: " << tableName << ": " << e.what() << std::endl;
-    }
-
-    return tableData;
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
 }
 
-TableSelectorBar::TableSelectorBar(const std::vector<std::string>& initialTables)
+TableSelectorBar::TableSelectorBar(const std::vector<TableInfo>& initialTables)
     : tables(initialTables)
 {
 }
 
-std::string TableSelectorBar::render(sql::Connection& conn)
+std::string TableSelectorBar::render(DbExecutor& db, const TableMenuActions& actions)
 {
     if (ImGui::BeginMenuBar())
     {
@@ -74,10 +37,26 @@ std::string TableSelectorBar::render(sql::Connection& conn)
         {
             for (size_t i = 0; i < tables.size(); ++i)
             {
-                if (ImGui::MenuItem(tables[i].c_str(), nullptr, selectedTableIndex == static_cast<int>(i)))
+                // Statystyki obok nazwy - wiadomo, co się otwiera, zanim poleci zapytanie
+                const TableInfo& info = tables[i];
+                std::string stats;
+                if (info.hasStats)
+                {
+                    char size[32];
+                    std::snprintf(size, sizeof(size), "%.1f MB", toMegabytes(info.dataBytes + info.indexBytes));
+                    stats = "~" + formatRowCount(info.approxRows) + " rows, " + size;
+                }
+
+                if (ImGui::MenuItem(info.name.c_str(), stats.empty() ? nullptr : stats.c_str(), selectedTableIndex == static_cast<int>(i)))
                 {
                     selectedTableIndex = static_cast<int>(i);
                 }
+                if (info.hasStats && ImGui::IsItemHovered())
+                {
+                    ImGui::SetTooltip("Estimated rows: %llu\nData: %.2f MB\nIndexes: %.2f MB",
+                                      static_cast<unsigned long long>(info.approxRows),
+                                      toMegabytes(info.dataBytes), toMegabytes(info.indexBytes));
+                }
             }
             ImGui::EndMenu();
         }
@@ -100,15 +79,52 @@ std::string TableSelectorBar::render(sql::Connection& conn)
                 openAddRowRequested = true;
             }
 
-            if (ImGui::MenuItem("Refresh"))
+            if (ImGui::MenuItem("Import CSV...", nullptr, false, !tables.empty() && actions.onImportCsv))
+            {
+                actions.onImportCsv(getSelectedTable());
+            }
+
+            if (ImGui::MenuItem("Export CSV/TSV...", nullptr, false, !tables.empty() && actions.onExportTable))
+            {
+                actions.onExportTable(getSelectedTable());
+            }
+
+            if (ImGui::MenuItem("Benchmark protocols...", nullptr, false, !tables.empty() && actions.onBenchmarkProtocols))
             {
-                auto newTables = getTablesFromDatabase(conn);
-                setTables(newTables);
+                actions.onBenchmarkProtocols(getSelectedTable());
+            }
+
+            if (ImGui::MenuItem("Refresh", nullptr, false, !refreshing))
+            {
+                refreshing = true;
+                db.submit(
+                    [](DbSession& session)
+                    {
+                        // Jawne odświeżenie - metadane schematu wczytają się od nowa przy następnym użyciu
+                        session.schema().invalidate();
+                        return getTablesFromDatabase(session.connection());
+                    },
+                    [this, onRefreshed = actions.onRefreshed](DbResult<std::vector<TableInfo>>& result)
+                    {
+                        refreshing = false;
+                        if (!result.ok())
+                        {
+                            refreshError = result.error;
+                            return;
+                        }
+                        refreshError.clear();
+                        setTables(result.value);
+                        if (onRefreshed)
+                            onRefreshed();
+                    });
             }
 
             ImGui::EndMenu();
         }
 
+        if (!refreshError.empty())
+            ImGui::TextColored(ImVec4(1, 0, 0, 1), "Refresh failed: %s", refreshError.c_str());
+
         ImGui::EndMenuBar();
     }
 
@@ -128,13 +144,16 @@ std::string TableSelectorBar::render(sql::Connection& conn)
         // Niezaimplementowane
     }
 
-    addRowToTable(conn, getSelectedTable());
+    addRowToTable(db, getSelectedTable(), actions.onRowsChanged);
 
-    return tables.empty() ? "" : tables[selectedTableIndex];
+    return getSelectedTable();
 }
 
-void TableSelectorBar::setTables(const std::vector<std::string>& newTables) 
+void TableSelectorBar::setTables(const std::vector<TableInfo>& newTables) 
 {
+    // Po odświeżeniu listy zostaje ta sama tabela, a nie ta, która trafiła pod jej dawny indeks
+    const std::string previous = getSelectedTable();
     tables = newTables;
-    selectedTableIndex = 0;  
+    auto it = std::find_if(tables.begin(), tables.end(), [&](const TableInfo& info) { return info.name == previous; });
+    selectedTableIndex = it != tables.end() ? static_cast<int>(it - tables.begin()) : 0;
 }
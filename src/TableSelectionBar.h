@@ -1,43 +1,44 @@
 #pragma once
 
 #include "TableOperations.h"
-#include <mariadb/conncpp.hpp>
+#include "TableFetch.h"
+#include "DbExecutor.h"
+#include <functional>
 #include <vector>
 #include <string>
-#include <memory>
-#include <iostream>
 
-struct Row 
+// Reakcje na akcje z menu Operation - wołane w wątku UI
+struct TableMenuActions
 {
-    std::vector<std::string> columns;
+    RowsChangedCallback onRowsChanged;                     // po dodaniu wierszy
+    std::function<void()> onRefreshed;                     // po odświeżeniu listy tabel
+    std::function<void(const std::string&)> onImportCsv;   // import działa w tle, poza paskiem
+    std::function<void(const std::string&)> onExportTable; // eksport również
+    std::function<void(const std::string&)> onBenchmarkProtocols;
 };
 
-struct TableData 
-{
-    std::vector<std::string> headers;
-    std::vector<Row> rows;
-};
-
-std::vector<std::string> getTablesFromDatabase(sql::Connection& conn);
-TableData getTableData(sql::Connection& conn, const std::string& tableName);
-
 class TableSelectorBar
 {
 public:
     TableSelectorBar() = default;
-    TableSelectorBar(const std::vector<std::string>& initialTables);
+    TableSelectorBar(const std::vector<TableInfo>& initialTables);
     
-    std::string render(sql::Connection& conn);
-    void setTables(const std::vector<std::string>& newTables);
+    std::string render(DbExecutor& db, const TableMenuActions& actions);
+    bool isRefreshing() const { return refreshing; }
+    void setTables(const std::vector<TableInfo>& newTables);
     int getSelectedTableIndex() const { return selectedTableIndex; }
-    std::string getSelectedTable() const { return tables.empty() ? "" : tables[selectedTableIndex]; }
+    std::string getSelectedTable() const { return tables.empty() ? "" : tables[selectedTableIndex].name; }
+    const TableInfo* getSelectedTableInfo() const { return tables.empty() ? nullptr : &tables[selectedTableIndex]; }
 
 
 
 private:
-    std::vector<std::string> tables;
+    std::vector<TableInfo> tables;
     int selectedTableIndex = 0;
 
+    bool refreshing = false;
+    std::string refreshError; // błąd ostatniego odświeżenia - lista tabel zostaje poprzednia
+
     bool openAddRowRequested = false;
     bool openCreateTableRequested = false;
     bool openDeleteTableRequested = false;
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Postęp długiego zadania w tle (import/eksport). Licznik pisze wątek zadania, UI tylko czyta co klatkę.
+struct TaskProgress
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::atomic<uint64_t> rows{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> totalBytes{0}; // 0 - nieznany rozmiar
+    std::atomic<bool> cancelRequested{false};
+    std::atomic<bool> finished{false};
+    std::atomic<bool> countersLive{true}; // false - rows/bytes znane dopiero po zakończeniu etapu
+
+    const Clock::time_point started = Clock::now();
+
+    void setStatus(std::string text)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        status = std::move(text);
+    }
+
+    std::string getStatus() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return status;
+    }
+
+    void fail(std::string message)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = std::move(message);
+    }
+
+    std::string getError() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return error;
+    }
+
+    // Wołane przez wątek zadania jako ostatnia operacja
+    void finish()
+    {
+        elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - started).count();
+        finished = true;
+    }
+
+    double getElapsedSeconds() const
+    {
+        const int64_t frozen = elapsedNs.load();
+        if (frozen >= 0)
+            return static_cast<double>(frozen) / 1e9;
+        return std::chrono::duration<double>(Clock::now() - started).count();
+    }
+
+    double getRowsPerSecond() const { return perSecond(rows.load()); }
+    double getBytesPerSecond() const { return perSecond(bytes.load()); }
+
+    // Ułamek 0..1 albo -1, gdy rozmiar nie jest znany
+    float getFraction() const
+    {
+        const uint64_t total = totalBytes.load();
+        if (total == 0)
+            return -1.0f;
+        return static_cast<float>(static_cast<double>(bytes.load()) / static_cast<double>(total));
+    }
+
+private:
+    double perSecond(uint64_t count) const
+    {
+        const double seconds = getElapsedSeconds();
+        return seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0;
+    }
+
+    mutable std::mutex mutex;
+    std::string status;
+    std::string error;
+    std::atomic<int64_t> elapsedNs{-1};
+};
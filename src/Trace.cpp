@@ -0,0 +1,136 @@
+#include "Trace.h"
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+    std::string escapeJson(const std::string& text)
+    {
+        std::string out;
+        out.reserve(text.size());
+        for (char c : text)
+        {
+            switch (c)
+            {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                        out += ' ';
+                    else
+                        out += c;
+            }
+        }
+        return out;
+    }
+}
+
+TraceRecorder& TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+uint32_t TraceRecorder::currentThreadId()
+{
+    static std::atomic<uint32_t> nextId{1};
+    thread_local const uint32_t id = nextId++;
+    return id;
+}
+
+void TraceRecorder::setThreadName(const char* name)
+{
+    TraceRecorder& recorder = instance();
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    recorder.threadNames[currentThreadId()] = name;
+}
+
+void TraceRecorder::start()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    events.clear();
+    dropped = 0;
+    epoch = Clock::now();
+    recording = true;
+}
+
+size_t TraceRecorder::getEventCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return events.size();
+}
+
+void TraceRecorder::addComplete(const char* name, const char* category, Clock::time_point begin, Clock::time_point end, std::string args)
+{
+    const uint32_t threadId = currentThreadId();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!recording)
+        return;
+    if (events.size() >= MAX_EVENTS)
+    {
+        ++dropped;
+        return;
+    }
+
+    events.push_back(Event{ name, category,
+                            std::chrono::duration<double, std::micro>(begin - epoch).count(),
+                            std::chrono::duration<double, std::micro>(end - begin).count(),
+                            threadId, std::move(args) });
+}
+
+bool TraceRecorder::stopAndSave(const std::string& path, std::string& error)
+{
+    std::vector<Event> recorded;
+    std::unordered_map<uint32_t, std::string> names;
+    size_t droppedEvents = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        recording = false;
+        recorded.swap(events);
+        names = threadNames;
+        droppedEvents = dropped;
+    }
+
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        error = "Cannot open " + path + " for writing";
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << droppedEvents << "},\"traceEvents\":[\n";
+
+    bool first = true;
+    for (const auto& [threadId, threadName] : names)
+    {
+        out << (first ? "" : ",\n")
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadId
+            << ",\"args\":{\"name\":\"" << escapeJson(threadName) << "\"}}";
+        first = false;
+    }
+
+    for (const Event& event : recorded)
+    {
+        out << (first ? "" : ",\n")
+            << "{\"name\":\"" << escapeJson(event.name) << "\",\"cat\":\"" << event.category
+            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId
+            << ",\"ts\":" << event.beginUs << ",\"dur\":" << event.durationUs;
+        if (!event.args.empty())
+            out << ",\"args\":" << event.args;
+        out << "}";
+        first = false;
+    }
+
+    out << "\n]}\n";
+    if (!out)
+    {
+        error = "Write error while saving " + path;
+        return false;
+    }
+    return true;
+}
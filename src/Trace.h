@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Nagrywanie śladu w formacie Chrome Trace Event (chrome://tracing, ui.perfetto.dev).
+// Gdy nagrywanie jest wyłączone, TRACE_SCOPE kosztuje jeden odczyt atomowej flagi.
+class TraceRecorder
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static TraceRecorder& instance();
+
+    void start();
+    // Zapisuje zebrane zdarzenia do pliku JSON i kończy nagrywanie; false przy błędzie zapisu
+    bool stopAndSave(const std::string& path, std::string& error);
+
+    bool isRecording() const { return recording.load(std::memory_order_relaxed); }
+    size_t getEventCount() const;
+
+    // Nazwa bieżącego wątku w śladzie (wątek UI, wątek bazy, import...)
+    static void setThreadName(const char* name);
+
+    // name i category muszą żyć do końca programu (literały); args - gotowy obiekt JSON albo pusty
+    void addComplete(const char* name, const char* category, Clock::time_point begin, Clock::time_point end, std::string args);
+
+private:
+    struct Event
+    {
+        const char* name;
+        const char* category;
+        double beginUs;
+        double durationUs;
+        uint32_t threadId;
+        std::string args;
+    };
+
+    static constexpr size_t MAX_EVENTS = 2'000'000; // ok. kilkaset MB JSON - dalsze zdarzenia są pomijane
+
+    static uint32_t currentThreadId();
+
+    std::atomic<bool> recording{false};
+    Clock::time_point epoch = Clock::now();
+
+    mutable std::mutex mutex;
+    std::vector<Event> events;
+    size_t dropped = 0;
+    std::unordered_map<uint32_t, std::string> threadNames; // przeżywa kolejne nagrania
+};
+
+// Zakres czasu zapisywany jako zdarzenie "X" (complete) przy wyjściu z zakresu
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* spanName, const char* spanCategory = "app")
+        : name(spanName), category(spanCategory), active(TraceRecorder::instance().isRecording())
+    {
+        if (active)
+            begin = TraceRecorder::Clock::now();
+    }
+
+    ~TraceScope()
+    {
+        if (active)
+            TraceRecorder::instance().addComplete(name, category, begin, TraceRecorder::Clock::now(), std::move(args));
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    bool isActive() const { return active; }
+    // Dodatkowe dane zdarzenia, np. {"rows":100}
+    void setArgs(std::string json) { args = std::move(json); }
+
+private:
+    const char* name;
+    const char* category;
+    bool active;
+    TraceRecorder::Clock::time_point begin;
+    std::string args;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_SCOPE_CAT(name, category) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name, category)
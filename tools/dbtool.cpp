@@ -0,0 +1,178 @@
+#include "ConnectionPool.h"
+#include "DbExecutor.h"
+#include "MariaDbBackend.h"
+#include "ResultRecording.h"
+#include "TableFetch.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Narzędzie wsadowe na bibliotece dbcore (bez ImGui i GLFW):
+//   dbtool <host> <port> <user> <database>          - lista tabel ze statystykami
+//   dbtool <host> <port> <user> <database> <table>  - zawartość tabeli jako TSV na stdout
+//   dbtool --record <plik> <host> ...                - to samo, z nagraniem wyników do pliku
+//   dbtool --replay <plik> [--realtime] [table]      - to samo z nagrania, bez serwera
+// Hasło z DB_PASSWORD, żeby nie było widoczne na liście procesów.
+
+// TSV w stylu LOAD DATA: NULL jako \N, znaki specjalne escapowane
+static void writeTsvValue(std::ostream& out, std::string_view value)
+{
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '\t': out << "\\t"; break;
+        case '\n': out << "\\n"; break;
+        case '\r': out << "\\r"; break;
+        case '\\': out << "\\\\"; break;
+        default:   out << c; break;
+        }
+    }
+}
+
+static const char* const USAGE =
+    "Usage: dbtool [--record <file>] <host> <port> <user> <database> [table]\n"
+    "       dbtool --replay <file> [--realtime] [table]\n"
+    "Password is read from the DB_PASSWORD environment variable.";
+
+// Lista tabel albo zrzut tabeli (table == nullptr - lista)
+static void run(DbConnection& conn, const char* table)
+{
+    if (!table)
+    {
+        std::cout << "table\tapprox_rows\tdata_bytes\tindex_bytes\n";
+        for (const TableInfo& info : getTablesFromDatabase(conn))
+        {
+            std::cout << info.name;
+            if (info.hasStats)
+                std::cout << '\t' << info.approxRows << '\t' << info.dataBytes << '\t' << info.indexBytes;
+            std::cout << '\n';
+        }
+        return;
+    }
+
+    // Zrzut wsadowy bez limitów przeglądania - wiersze idą na wyjście partiami, pamięć zostaje stała
+    TableQuery query;
+    query.limits = QueryLimits{ 0.0, 0, 0, true };
+
+    bool headerWritten = false;
+    CellBuffer buffer;
+    streamTableData(conn, table, query, 1000, [&](TableData&& batch)
+    {
+        const size_t columnCount = batch.getColumnCount();
+        if (!headerWritten)
+        {
+            for (size_t c = 0; c < columnCount; ++c)
+            {
+                if (c > 0)
+                    std::cout << '\t';
+                writeTsvValue(std::cout, batch.getHeaders()[c]);
+            }
+            std::cout << '\n';
+            headerWritten = true;
+        }
+
+        for (size_t r = 0; r < batch.getRowCount(); ++r)
+        {
+            for (size_t c = 0; c < columnCount; ++c)
+            {
+                if (c > 0)
+                    std::cout << '\t';
+                if (batch.isNull(r, c))
+                    std::cout << "\\N";
+                else
+                    writeTsvValue(std::cout, batch.getCell(r, c, buffer));
+            }
+            std::cout << '\n';
+        }
+        return static_cast<bool>(std::cout);
+    });
+}
+
+int main(int argc, char** argv)
+{
+    std::string recordPath;
+    std::string replayPath;
+    bool realTime = false;
+    std::vector<const char*> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (std::strcmp(argv[i], "--realtime") == 0)
+            realTime = true;
+        else
+            args.push_back(argv[i]);
+    }
+
+    const bool replay = !replayPath.empty();
+    const size_t required = replay ? 0 : 4;
+    if (args.size() < required || args.size() > required + 1 || (replay && !recordPath.empty()))
+    {
+        std::cerr << USAGE << std::endl;
+        return 2;
+    }
+    const char* table = args.size() > required ? args[required] : nullptr;
+
+    try
+    {
+        if (replay)
+        {
+            ReplayBackend backend;
+            std::string error;
+            if (!backend.load(replayPath, error))
+            {
+                std::cerr << "Error: " << error << std::endl;
+                return 1;
+            }
+            backend.setRealTime(realTime);
+            std::unique_ptr<DbConnection> conn = backend.connect(DbEndpoint{}, {});
+            run(*conn, table);
+            return 0;
+        }
+
+        const char* password = std::getenv("DB_PASSWORD");
+        const DbEndpoint endpoint{ args[0], args[1], args[2], password ? password : "" };
+        const std::string database = args[3];
+
+        ConnectionPool pool;
+        DbSession session(pool);
+        PooledConnection pooled = pool.checkout(endpoint);
+        pooled->setSchema(database);
+        session.setConnection(std::move(pooled), endpoint);
+
+        MariaDbConnection conn(session.connection());
+        if (recordPath.empty())
+        {
+            run(conn, table);
+            return 0;
+        }
+
+        ResultRecorder& recorder = ResultRecorder::instance();
+        recorder.start();
+        RecordingConnection recording(conn, recorder);
+        run(recording, table);
+
+        std::string error;
+        const bool saved = recorder.stopAndSave(recordPath, error);
+        if (!error.empty())
+            std::cerr << (saved ? "Warning: " : "Error: ") << error << std::endl;
+        if (!saved)
+            return 1;
+    }
+    catch (sql::SQLException& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
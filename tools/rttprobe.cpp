@@ -0,0 +1,256 @@
+#include "ConnectionPool.h"
+#include "DbExecutor.h"
+#include "RowOperations.h"
+#include "TableFetch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Czas operacji aplikacji z perspektywy użytkownika - do uruchamiania przez rttproxy (bench/rtt_bench.sh):
+//   rttprobe <host> <port> <user> <database> [--rows <n>] [--iterations <n>] [--label <tekst>]
+// Odtwarza te same sekwencje zapytań co aplikacja, jedno po drugim w jednej sesji:
+//   table_open - schemat tabeli (klucz główny), potem strumień wierszy jak w TableDataCache
+//   add_row    - kolumny do formularza, INSERT, przeładowanie tabeli
+//   update_row - kolumny i bieżące wartości wiersza, UPDATE, przeładowanie tabeli
+// Dla każdej: czas do pierwszego wiersza i do pełnej tabeli (mediana z iteracji), jako JSON w wierszu.
+// Pracuje na własnej tabeli rtt_probe, tworzonej na początku i usuwanej na końcu. Hasło z DB_PASSWORD.
+
+using Clock = std::chrono::steady_clock;
+
+static const char* const PROBE_TABLE = "rtt_probe";
+// Tyle samo co domyślnie w TableDataCache
+static constexpr size_t FETCH_SIZE = 1000;
+
+struct Sample
+{
+    double firstRowMs = -1.0;
+    double fullTableMs = 0.0;
+};
+
+static double msSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Otwarcie tabeli jak w TableDataCache: schemat przed danymi, potem partie strumienia
+static Sample openTable(DbSession& session, Clock::time_point start, std::string* firstPk = nullptr)
+{
+    Sample sample;
+    session.schema().getTable(session.connection(), PROBE_TABLE);
+
+    CellBuffer buffer;
+    streamTableData(session, PROBE_TABLE, TableQuery{}, FETCH_SIZE, [&](TableData&& batch)
+    {
+        if (sample.firstRowMs < 0.0 && batch.getRowCount() > 0)
+        {
+            sample.firstRowMs = msSince(start);
+            if (firstPk)
+                *firstPk = std::string(batch.getCell(0, 0, buffer));
+        }
+        return true;
+    });
+    sample.fullTableMs = msSince(start);
+    return sample;
+}
+
+static void createProbeTable(DbSession& session, size_t rows)
+{
+    sql::Connection& conn = session.connection();
+    std::unique_ptr<sql::Statement> stmt(conn.createStatement());
+    stmt->execute(std::string("DROP TABLE IF EXISTS `") + PROBE_TABLE + "`");
+    stmt->execute(std::string("CREATE TABLE `") + PROBE_TABLE + "` ("
+                  "id INT AUTO_INCREMENT PRIMARY KEY, customer VARCHAR(64) NOT NULL, "
+                  "amount DECIMAL(10,2), created_at DATETIME, note VARCHAR(255))");
+    session.schema().invalidate(); // DDL
+
+    const std::vector<std::string> cols = { "customer", "amount", "created_at", "note" };
+    std::vector<std::vector<std::string>> values;
+    values.reserve(rows);
+    for (size_t i = 0; i < rows; ++i)
+        values.push_back({ "customer-" + std::to_string(i % 500), std::to_string(i % 1000) + ".50", "2024-01-01 12:00:00",
+                           "probe row " + std::to_string(i) });
+
+    auto schema = requireTableSchema(session, PROBE_TABLE);
+    insertRows(conn, *schema, cols, values, queryMaxAllowedPacket(conn));
+}
+
+static double median(std::vector<double> values)
+{
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    const size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+// Etykieta trafia do JSON jako napis - cudzysłowy, ukośniki i znaki sterujące muszą być zakodowane
+static std::string jsonEscape(const std::string& text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '"':  escaped += "\\\""; break;
+        case '\\': escaped += "\\\\"; break;
+        case '\n': escaped += "\\n"; break;
+        case '\r': escaped += "\\r"; break;
+        case '\t': escaped += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(c)));
+                escaped += code;
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+    }
+    return escaped;
+}
+
+// Usuwa tabelę próbną także wtedy, gdy pomiar przerwał wyjątek - nie zostawia jej w bazie użytkownika
+class ProbeTableGuard
+{
+public:
+    explicit ProbeTableGuard(DbSession& owner) : session(owner) {}
+    ProbeTableGuard(const ProbeTableGuard&) = delete;
+    ProbeTableGuard& operator=(const ProbeTableGuard&) = delete;
+
+    ~ProbeTableGuard()
+    {
+        try
+        {
+            std::unique_ptr<sql::Statement> stmt(session.connection().createStatement());
+            stmt->execute(std::string("DROP TABLE IF EXISTS `") + PROBE_TABLE + "`");
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "Error dropping " << PROBE_TABLE << ": " << e.what() << std::endl;
+        }
+    }
+
+private:
+    DbSession& session;
+};
+
+static void report(const std::string& label, const char* scenario, const std::vector<Sample>& samples)
+{
+    std::vector<double> firstRow;
+    std::vector<double> fullTable;
+    for (const Sample& sample : samples)
+    {
+        firstRow.push_back(sample.firstRowMs);
+        fullTable.push_back(sample.fullTableMs);
+    }
+
+    char line[256];
+    std::snprintf(line, sizeof(line),
+                  "\"scenario\": \"%s\", \"iterations\": %zu, \"first_row_ms\": %.1f, \"full_table_ms\": %.1f}",
+                  scenario, samples.size(), median(firstRow), median(fullTable));
+    std::cout << "{\"label\": \"" << jsonEscape(label) << "\", " << line << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<const char*> args;
+    size_t rows = 5000;
+    int iterations = 5;
+    std::string label;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--rows") == 0 && i + 1 < argc)
+            rows = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+            iterations = std::max(std::atoi(argv[++i]), 1);
+        else if (std::strcmp(argv[i], "--label") == 0 && i + 1 < argc)
+            label = argv[++i];
+        else
+            args.push_back(argv[i]);
+    }
+
+    if (args.size() != 4 || rows == 0)
+    {
+        std::cerr << "Usage: rttprobe <host> <port> <user> <database> [--rows <n>] [--iterations <n>] [--label <text>]\n"
+                     "Password is read from the DB_PASSWORD environment variable." << std::endl;
+        return 2;
+    }
+
+    const char* password = std::getenv("DB_PASSWORD");
+    const DbEndpoint endpoint{ args[0], args[1], args[2], password ? password : "" };
+    if (label.empty())
+        label = endpoint.host + ":" + endpoint.port;
+
+    try
+    {
+        ConnectionPool pool;
+        DbSession session(pool);
+        PooledConnection conn = pool.checkout(endpoint);
+        conn->setSchema(args[3]);
+        session.setConnection(std::move(conn), endpoint);
+
+        // Przed utworzeniem - częściowo wypełniona tabela też jest usuwana
+        ProbeTableGuard probeTable(session);
+        createProbeTable(session, rows);
+
+        std::string pkValue;
+        std::vector<Sample> opens;
+        for (int i = 0; i < iterations; ++i)
+        {
+            // Pierwsze otwarcie tabeli - bez schematu w SchemaCache
+            session.schema().invalidate();
+            opens.push_back(openTable(session, Clock::now(), &pkValue));
+        }
+        report(label, "table_open", opens);
+
+        std::vector<Sample> adds;
+        for (int i = 0; i < iterations; ++i)
+        {
+            const Clock::time_point start = Clock::now();
+            auto schema = requireTableSchema(session, PROBE_TABLE);
+            insertRow(session, *schema, { "customer", "amount", "created_at", "note" },
+                      { "customer-new", "99.99", "now", "added by rttprobe" });
+            adds.push_back(openTable(session, start));
+        }
+        report(label, "add_row", adds);
+
+        std::vector<Sample> updates;
+        for (int i = 0; i < iterations; ++i)
+        {
+            const Clock::time_point start = Clock::now();
+            auto schema = requireTableSchema(session, PROBE_TABLE);
+            LoadedRow row = loadRowByPk(session, *schema, "id", pkValue);
+            if (!row.found)
+                throw std::runtime_error("Probe row " + pkValue + " not found");
+            for (size_t c = 0; c < row.columns.size(); ++c)
+            {
+                if (row.columns[c] == "note")
+                    row.values[c] = "updated " + std::to_string(i);
+            }
+            updateRow(session, PROBE_TABLE, row.columns, row.values, "id", pkValue);
+            updates.push_back(openTable(session, start));
+        }
+        report(label, "update_row", updates);
+    }
+    catch (sql::SQLException& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
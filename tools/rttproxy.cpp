@@ -0,0 +1,310 @@
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+// Lokalne proxy TCP z opóźnieniem - symuluje odległy serwer przy bazie z docker-compose:
+//   rttproxy [--listen <port>] [--target <host:port>] [--rtt <ms>] [--jitter <ms>] [--bandwidth <kbit/s>]
+// Aplikacja łączy się z 127.0.0.1:<listen> zamiast z bazą. Każdy kierunek dostaje połowę RTT (plus
+// losowy jitter), a przy limicie pasma dane wychodzą nie szybciej niż zadana przepustowość,
+// a w drodze jest najwyżej tyle danych, ile łącze przenosi w czasie RTT.
+// Kolejność bajtów jest zachowana - jitter nie przestawia pakietów, jak w prawdziwym TCP.
+
+using Clock = std::chrono::steady_clock;
+
+struct ProxyOptions
+{
+    int listenPort = 3308;
+    std::string targetHost = "127.0.0.1";
+    std::string targetPort = "3307";
+    double rttMs = 0.0;
+    double jitterMs = 0.0;
+    double bandwidthKbps = 0.0; // 0 - bez limitu
+};
+
+// Oba gniazda połączenia - zamykane, gdy skończą się wszystkie cztery wątki
+struct Link
+{
+    int client = -1;
+    int server = -1;
+
+    ~Link()
+    {
+        if (client >= 0)
+            close(client);
+        if (server >= 0)
+            close(server);
+    }
+};
+
+static constexpr size_t READ_CHUNK_BYTES = 65536;
+// Bez limitu pasma kolejka działa jak okno TCP - nadawca czeka, gdy odbiorca nie nadąża
+static constexpr size_t UNLIMITED_QUEUE_BYTES = size_t{ 16 } << 20;
+
+// Bajty w drodze: przy limicie pasma tyle, ile łącze przenosi w czasie RTT, plus jeden fragment
+static size_t maxQueuedBytes(const ProxyOptions& options)
+{
+    if (options.bandwidthKbps <= 0.0)
+        return UNLIMITED_QUEUE_BYTES;
+    const double inFlight = options.bandwidthKbps * 1000.0 / 8.0 * (options.rttMs + options.jitterMs) / 1000.0;
+    return std::max(static_cast<size_t>(inFlight), READ_CHUNK_BYTES) + READ_CHUNK_BYTES;
+}
+
+// Jeden kierunek: wątek czytający znakuje dane czasem doręczenia, wątek piszący czeka do tego czasu.
+// Kolejka jest ograniczona - pełna wstrzymuje czytanie, więc nadawca odczuwa limit pasma jak w sieci
+class Direction
+{
+public:
+    Direction(const ProxyOptions& options, unsigned seed) : oneWayMs(options.rttMs / 2.0), jitterMs(options.jitterMs),
+        bytesPerSecond(options.bandwidthKbps * 1000.0 / 8.0), queueLimit(maxQueuedBytes(options)), random(seed) {}
+
+    void read(int from)
+    {
+        char buffer[READ_CHUNK_BYTES];
+        for (;;)
+        {
+            const ssize_t n = recv(from, buffer, sizeof(buffer), 0);
+            // Pusty fragment oznacza koniec strumienia
+            push(n > 0 ? std::string(buffer, static_cast<size_t>(n)) : std::string());
+            if (n <= 0)
+                return;
+        }
+    }
+
+    void write(int from, int to)
+    {
+        Clock::time_point linkFree = Clock::now();
+        for (;;)
+        {
+            Chunk chunk = pop();
+            std::this_thread::sleep_until(std::max(chunk.deliverAt, linkFree));
+            if (chunk.data.empty())
+            {
+                shutdown(to, SHUT_WR);
+                return;
+            }
+
+            size_t sent = 0;
+            while (sent < chunk.data.size())
+            {
+                const ssize_t n = send(to, chunk.data.data() + sent, chunk.data.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0)
+                {
+                    // Druga strona zniknęła - odblokowuje wątek czytający ten kierunek
+                    abandon();
+                    shutdown(from, SHUT_RDWR);
+                    return;
+                }
+                sent += static_cast<size_t>(n);
+            }
+
+            if (bytesPerSecond > 0.0)
+            {
+                const std::chrono::duration<double> transfer(static_cast<double>(chunk.data.size()) / bytesPerSecond);
+                linkFree = std::max(linkFree, Clock::now()) + std::chrono::duration_cast<Clock::duration>(transfer);
+            }
+        }
+    }
+
+private:
+    struct Chunk
+    {
+        Clock::time_point deliverAt;
+        std::string data;
+    };
+
+    void push(std::string data)
+    {
+        double delayMs = oneWayMs;
+        if (jitterMs > 0.0)
+            delayMs += std::uniform_real_distribution<double>(-jitterMs, jitterMs)(random);
+        const Clock::time_point now = Clock::now();
+        Clock::time_point deliverAt = now + std::chrono::duration_cast<Clock::duration>(
+                                                std::chrono::duration<double, std::milli>(std::max(delayMs, 0.0)));
+
+        std::unique_lock<std::mutex> lock(mutex);
+        // Pełna kolejka - czekamy na wątek piszący zamiast zbierać dane w pamięci
+        space.wait(lock, [&] { return abandoned || queue.empty() || queuedBytes + data.size() <= queueLimit; });
+        if (abandoned)
+            return;
+
+        // Nie wcześniej niż poprzedni fragment - strumień TCP nie może się przestawić
+        deliverAt = std::max(deliverAt, lastDeliverAt);
+        lastDeliverAt = deliverAt;
+        queuedBytes += data.size();
+        queue.push_back(Chunk{ deliverAt, std::move(data) });
+        ready.notify_one();
+    }
+
+    Chunk pop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return !queue.empty(); });
+        Chunk chunk = std::move(queue.front());
+        queue.pop_front();
+        queuedBytes -= chunk.data.size();
+        space.notify_one();
+        return chunk;
+    }
+
+    // Wątek piszący kończy pracę - czytający nie może czekać na miejsce w kolejce
+    void abandon()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        abandoned = true;
+        queue.clear();
+        queuedBytes = 0;
+        space.notify_one();
+    }
+
+    double oneWayMs;
+    double jitterMs;
+    double bytesPerSecond;
+    size_t queueLimit;
+    std::mt19937 random;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::condition_variable space;
+    std::deque<Chunk> queue;
+    size_t queuedBytes = 0;
+    bool abandoned = false;
+    Clock::time_point lastDeliverAt{};
+};
+
+static void setNoDelay(int fd)
+{
+    // Bez Nagle'a - małe pakiety protokołu nie czekają na ACK, mierzone jest tylko wstrzyknięte opóźnienie
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+static int connectTarget(const ProxyOptions& options)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(options.targetHost.c_str(), options.targetPort.c_str(), &hints, &addresses) != 0)
+        return -1;
+
+    int fd = -1;
+    for (addrinfo* a = addresses; a && fd < 0; a = a->ai_next)
+    {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    return fd;
+}
+
+static void startDirection(const std::shared_ptr<Link>& link, const ProxyOptions& options, unsigned seed, bool upstream)
+{
+    auto direction = std::make_shared<Direction>(options, seed);
+    const int from = upstream ? link->client : link->server;
+    const int to = upstream ? link->server : link->client;
+    std::thread([link, direction, from] { direction->read(from); }).detach();
+    std::thread([link, direction, from, to] { direction->write(from, to); }).detach();
+}
+
+static bool parseArgs(int argc, char** argv, ProxyOptions& options)
+{
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string name = argv[i];
+        const char* value = argv[i + 1];
+        if (name == "--listen")
+            options.listenPort = std::atoi(value);
+        else if (name == "--target")
+        {
+            const std::string target = value;
+            const size_t colon = target.rfind(':');
+            if (colon == std::string::npos)
+                return false;
+            options.targetHost = target.substr(0, colon);
+            options.targetPort = target.substr(colon + 1);
+        }
+        else if (name == "--rtt")
+            options.rttMs = std::atof(value);
+        else if (name == "--jitter")
+            options.jitterMs = std::atof(value);
+        else if (name == "--bandwidth")
+            options.bandwidthKbps = std::atof(value);
+        else
+            return false;
+    }
+    return argc % 2 == 1 && options.listenPort > 0 && options.listenPort < 65536;
+}
+
+int main(int argc, char** argv)
+{
+    ProxyOptions options;
+    if (!parseArgs(argc, argv, options))
+    {
+        std::cerr << "Usage: rttproxy [--listen <port>] [--target <host:port>] [--rtt <ms>] [--jitter <ms>] [--bandwidth <kbit/s>]\n"
+                     "Defaults: --listen 3308 --target 127.0.0.1:3307 (docker-compose MariaDB), no latency." << std::endl;
+        return 2;
+    }
+
+    const int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    // Tylko pętla zwrotna - proxy nie ma być widoczne z sieci
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(options.listenPort));
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 16) != 0)
+    {
+        std::cerr << "Cannot listen on 127.0.0.1:" << options.listenPort << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::cerr << "127.0.0.1:" << options.listenPort << " -> " << options.targetHost << ":" << options.targetPort
+              << ", rtt " << options.rttMs << " ms, jitter " << options.jitterMs << " ms, bandwidth ";
+    if (options.bandwidthKbps > 0.0)
+        std::cerr << options.bandwidthKbps << " kbit/s" << std::endl;
+    else
+        std::cerr << "unlimited" << std::endl;
+
+    std::random_device seeds;
+    for (;;)
+    {
+        const int client = accept(listener, nullptr, nullptr);
+        if (client < 0)
+            continue;
+
+        auto link = std::make_shared<Link>();
+        link->client = client;
+        link->server = connectTarget(options);
+        if (link->server < 0)
+        {
+            std::cerr << "Cannot connect to " << options.targetHost << ":" << options.targetPort << std::endl;
+            continue; // link zamyka gniazdo klienta
+        }
+
+        setNoDelay(link->client);
+        setNoDelay(link->server);
+        startDirection(link, options, seeds(), true);
+        startDirection(link, options, seeds(), false);
+    }
+}